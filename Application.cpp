@@ -4,7 +4,10 @@
 #include "classes/Checkers.h"
 #include "classes/Othello.h"
 #include "classes/Connect4.h"
+#include <cfloat>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace ClassGame {
         //
@@ -13,6 +16,7 @@ namespace ClassGame {
         Game *game = nullptr;
         bool gameOver = false;
         std::string gameWinner = "";
+        int connect4Variant = 0;        // index into Connect4Engine::variant()
 
         //
         // game starting point
@@ -23,6 +27,50 @@ namespace ClassGame {
             game = nullptr;
         }
 
+        //
+        // game shutdown
+        // this is called by main.cpp once the render loop exits, so no AI worker outlives the window
+        //
+        void GameShutDown()
+        {
+            if (game) {
+                game->cancelAISearch();
+                delete game;
+                game = nullptr;
+            }
+        }
+
+        //
+        // cost of the AI's last search and a rolling plot of recent ones, so a slow
+        // move or a regression shows without attaching a profiler
+        //
+        void DrawSearchStats(const Game &game)
+        {
+            const std::vector<SearchStats> history = game.searchStatsHistory();
+            if (history.empty() || !ImGui::CollapsingHeader("AI search statistics", ImGuiTreeNodeFlags_DefaultOpen))
+                return;
+
+            const SearchStats &last = history.back();
+            ImGui::Text("Nodes: %llu", (unsigned long long)last.nodes);
+            ImGui::Text("Nodes/sec: %.0f", last.nodesPerSecond());
+            ImGui::Text("Depth: %d", last.depth);
+            ImGui::Text("TT hit rate: %.1f%%", 100.0 * last.tableHitRate());
+            ImGui::Text("First-move cutoffs: %.1f%%", 100.0 * last.firstMoveCutoffRate());
+            ImGui::Text("Time: %.1f ms", last.timeMs);
+            if (game.ponderChecks() > 0) {
+                ImGui::Text("Ponder hits: %d / %d (%.0f%%)", game.ponderHits(), game.ponderChecks(),
+                            100.0 * game.ponderHits() / game.ponderChecks());
+            }
+
+            std::vector<float> nodesPerSecond, timeMs;
+            for (const SearchStats &stats : history) {
+                nodesPerSecond.push_back((float)(stats.nodesPerSecond() / 1000.0));
+                timeMs.push_back((float)stats.timeMs);
+            }
+            ImGui::PlotLines("knodes/sec", nodesPerSecond.data(), (int)nodesPerSecond.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+            ImGui::PlotLines("time (ms)", timeMs.data(), (int)timeMs.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+        }
+
         //
         // game render loop
         // this is called by the main render loop in main.cpp
@@ -39,6 +87,7 @@ namespace ClassGame {
                     ImGui::Text("Game Over!");
                     ImGui::Text("Winner: %s", gameWinner.c_str());
                     if (ImGui::Button("Reset Game")) {
+                        game->cancelAISearch();
                         game->stopGame();
                         game->setUpBoard();
                         gameOver = false;
@@ -49,12 +98,14 @@ namespace ClassGame {
                 // Always allow restart or quit while a game exists
                 if (game) {
                     if (ImGui::Button("Restart")) {
+                        game->cancelAISearch();
                         game->stopGame();
                         game->setUpBoard();
                         gameOver = false;
                         gameWinner = "";
                     }
                     if (ImGui::Button("Quit")) {
+                        game->cancelAISearch();
                         delete game;
                         game = nullptr;
                         gameOver = false;
@@ -76,16 +127,19 @@ namespace ClassGame {
                         game = new Othello();
                         game->setUpBoard();
                     }
+                    ImGui::Combo("Connect 4 board", &connect4Variant, [](void *, int index) {
+                        return Connect4Engine::variant(index).name;
+                    }, nullptr, Connect4Engine::variantCount());
                     if (ImGui::Button("Start Connect 4 vs AI (AI as Yellow)")) {
-                        game = new Connect4();
+                        game = new Connect4(true, AI_PLAYER, connect4Variant);
                         game->setUpBoard();
                     }
                     if (ImGui::Button("Start Connect 4 vs AI (AI as Red)")) {
-                        game = new Connect4(true, 0);
+                        game = new Connect4(true, 0, connect4Variant);
                         game->setUpBoard();
                     }
                     if (ImGui::Button("Start Connect 4 vs Player")) {
-                        game = new Connect4(false);
+                        game = new Connect4(false, AI_PLAYER, connect4Variant);
                         game->setUpBoard();
                     }
                 } else {
@@ -96,6 +150,14 @@ namespace ClassGame {
                         ImGui::Text("Current Player Number: %d", game->getCurrentPlayer()->playerNumber());
                     }
                     ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                    if (game->gameHasAI()) {
+                        ImGui::SliderInt("AI time (ms)", &game->_gameOptions.AITimeBudgetMs, 50, 5000);
+                        ImGui::SliderInt("AI threads (0 = all)", &game->_gameOptions.AIThreads, 0, (int)std::thread::hardware_concurrency());
+                        ImGui::Checkbox("AI perfect play", &game->_gameOptions.AIPerfectPlay);
+                        ImGui::Checkbox("AI ponder on your time", &game->_gameOptions.AIPonder);
+                        ImGui::SliderInt("AI ponder threads (0 = all)", &game->_gameOptions.AIPonderThreads, 0, (int)std::thread::hardware_concurrency());
+                        DrawSearchStats(*game);
+                    }
                 }
                 ImGui::End();
 
@@ -106,6 +168,10 @@ namespace ClassGame {
                         {
                             game->updateAI();
                         }
+                        else if (game->gameHasAI() && game->_gameOptions.AIPonder)
+                        {
+                            game->ponderAI();
+                        }
                     }
                     game->drawFrame();
                 }
@@ -118,13 +184,13 @@ namespace ClassGame {
         //
         void EndOfTurn() 
         {
-            Player *winner = game->checkForWinner();
-            if (winner)
+            const GameOutcome outcome = game->checkForOutcome();
+            if (outcome.winner)
             {
                 gameOver = true;
-                gameWinner = winner->playerNumber() == 0 ? "red" : "yellow";
+                gameWinner = outcome.winner->playerNumber() == 0 ? "red" : "yellow";
             }
-            if (game->checkForDraw()) {
+            else if (outcome.draw) {
                 gameOver = true;
                 gameWinner = "draw";
             }
@@ -6,6 +6,7 @@ namespace ClassGame {
     extern std::string gameWinner;
 
     void GameStartUp();
+    void GameShutDown();
     void RenderGame();
     void EndOfTurn();
 }
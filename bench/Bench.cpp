@@ -0,0 +1,204 @@
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <thread>
+
+//
+// bench [--filter=REGEX] [--min_time=SECONDS] [--json] [--out=FILE]
+//
+// prints a console table by default; --json prints Google Benchmark JSON on stdout
+// instead, and --out writes that JSON to a file alongside the console table.
+//
+namespace bench {
+
+namespace {
+
+struct Registered
+{
+    std::string name;
+    Function    function;
+};
+
+struct Result
+{
+    std::string name;
+    uint64_t    iterations;
+    double      realNs;     // per iteration
+    double      cpuNs;      // per iteration, summed over every thread of the process
+    double      itemsPerSecond;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+std::vector<Registered> &registry()
+{
+    static std::vector<Registered> benchmarks;
+    return benchmarks;
+}
+
+double processCpuSeconds()
+{
+    return (double)std::clock() / CLOCKS_PER_SEC;
+}
+
+// run with 1, then ~10x more iterations until the body takes at least minTime
+Result runBenchmark(const Registered &benchmark, double minTime)
+{
+    uint64_t iterations = 1;
+    for (;;) {
+        State state(iterations);
+        const double cpuStart = processCpuSeconds();
+        benchmark.function(state);
+        const double cpuSeconds = processCpuSeconds() - cpuStart;
+        const double seconds = state.elapsedSeconds();
+
+        if (seconds >= minTime || iterations >= 1000000000ull) {
+            Result result;
+            result.name = benchmark.name;
+            result.iterations = iterations;
+            result.realNs = seconds * 1e9 / iterations;
+            result.cpuNs = cpuSeconds * 1e9 / iterations;
+            result.itemsPerSecond = seconds > 0.0 ? state.itemsProcessed() / seconds : 0.0;
+            result.counters = state.counters();
+            return result;
+        }
+
+        // aim a little past minTime, but never grow more than 10x in one step
+        double scale = seconds > 0.0 ? minTime * 1.4 / seconds : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        if (scale < 2.0) scale = 2.0;
+        iterations = (uint64_t)(iterations * scale);
+    }
+}
+
+std::string escapeJson(const std::string &s)
+{
+    std::string escaped;
+    for (char c : s) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJson(std::ostream &out, const std::vector<Result> &results)
+{
+    char date[64];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << escapeJson(r.name) << "\",\n";
+        out << "      \"run_name\": \"" << escapeJson(r.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"real_time\": " << r.realNs << ",\n";
+        out << "      \"cpu_time\": " << r.cpuNs << ",\n";
+        out << "      \"time_unit\": \"ns\",\n";
+        for (const auto &counter : r.counters) {
+            out << "      \"" << escapeJson(counter.first) << "\": " << counter.second << ",\n";
+        }
+        out << "      \"items_per_second\": " << r.itemsPerSecond << "\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+void printRow(const Result &r)
+{
+    std::printf("%-44s %14.0f ns %14.0f ns %12llu %14.4g items/s\n",
+                r.name.c_str(), r.realNs, r.cpuNs, (unsigned long long)r.iterations, r.itemsPerSecond);
+    std::fflush(stdout);
+}
+
+}
+
+bool registerBenchmark(const std::string &name, Function function)
+{
+    registry().push_back({name, function});
+    return true;
+}
+
+static volatile uint64_t sink;
+
+void doNotOptimize(uint64_t value)
+{
+    sink = sink + value;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    std::string filter = ".*";
+    std::string outPath;
+    double minTime = 0.5;
+    bool jsonToStdout = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(9);
+        } else if (arg.rfind("--min_time=", 0) == 0) {
+            minTime = std::atof(arg.c_str() + 11);
+        } else if (arg.rfind("--out=", 0) == 0) {
+            outPath = arg.substr(6);
+        } else if (arg == "--json") {
+            jsonToStdout = true;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--filter=REGEX] [--min_time=SECONDS] [--json] [--out=FILE]\n";
+            return 1;
+        }
+    }
+
+    std::regex pattern;
+    try {
+        pattern = std::regex(filter);
+    } catch (const std::regex_error &) {
+        std::cerr << "bad --filter regex: " << filter << "\n";
+        return 1;
+    }
+
+    if (!jsonToStdout) {
+        std::printf("%-44s %17s %17s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    }
+
+    std::vector<bench::Result> results;
+    for (const bench::Registered &benchmark : bench::registry()) {
+        if (!std::regex_search(benchmark.name, pattern)) continue;
+        results.push_back(bench::runBenchmark(benchmark, minTime));
+        if (!jsonToStdout) {
+            bench::printRow(results.back());
+        }
+    }
+
+    if (jsonToStdout) {
+        bench::writeJson(std::cout, results);
+    }
+    if (!outPath.empty()) {
+        std::ofstream out(outPath);
+        if (!out) {
+            std::cerr << "cannot write " << outPath << "\n";
+            return 1;
+        }
+        bench::writeJson(out, results);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+//
+// a small Google-Benchmark style harness
+//
+// a benchmark is a function taking a State and running its body once per
+// keepRunning() call. the runner repeats it with a growing iteration count
+// until it takes long enough to time reliably, and writes the results in
+// Google Benchmark's JSON layout so existing dashboards can read them.
+//
+namespace bench {
+
+class State
+{
+public:
+    explicit State(uint64_t iterations) : _iterations(iterations), _done(0), _items(0) {}
+
+    // true while the body should run again; starts the clock on the first call
+    bool        keepRunning()
+    {
+        if (_done == 0) {
+            _start = std::chrono::steady_clock::now();
+        }
+        if (_done == _iterations) {
+            _elapsed = std::chrono::steady_clock::now() - _start;
+            return false;
+        }
+        _done++;
+        return true;
+    }
+
+    uint64_t    iterations() const { return _iterations; }
+    double      elapsedSeconds() const { return _elapsed.count(); }
+
+    // work units done in total (nodes, calls, ...); reported as items_per_second
+    void        setItemsProcessed(uint64_t items) { _items = items; }
+    uint64_t    itemsProcessed() const { return _items; }
+
+    // extra named values copied into the JSON entry
+    void        setCounter(const std::string &name, double value) { _counters.push_back({name, value}); }
+    const std::vector<std::pair<std::string, double>> &counters() const { return _counters; }
+
+private:
+    uint64_t    _iterations;
+    uint64_t    _done;
+    uint64_t    _items;
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::duration<double> _elapsed{0.0};
+    std::vector<std::pair<std::string, double>> _counters;
+};
+
+typedef std::function<void(State &)> Function;
+
+// add a benchmark to the global list; returns true so it can initialise a static
+bool registerBenchmark(const std::string &name, Function function);
+
+// hand a result to another translation unit so the optimiser cannot drop the work behind it
+void doNotOptimize(uint64_t value);
+
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+// BENCHMARK("name", [](bench::State &state) { ... });
+#define BENCHMARK(name, ...) \
+    static const bool BENCH_CONCAT(benchRegistered_, __LINE__) = bench::registerBenchmark(name, __VA_ARGS__)
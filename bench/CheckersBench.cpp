@@ -0,0 +1,81 @@
+#include "Bench.h"
+#include "CheckersBoard.h"
+#include <random>
+
+namespace {
+
+struct Step
+{
+    int srcX, srcY, dstX, dstY;
+};
+
+// every legal single step for player; slow, but only used to build the corpus
+std::vector<Step> legalSteps(const CheckersBoard &board, int player)
+{
+    std::vector<Step> steps;
+    for (int y = 0; y < CheckersBoard::SIZE; y++) {
+        for (int x = 0; x < CheckersBoard::SIZE; x++) {
+            if (CheckersBoard::ownerOf(board.pieceAt(x, y)) != player) continue;
+            for (int dy = -2; dy <= 2; dy++) {
+                for (int dx = -2; dx <= 2; dx++) {
+                    if (board.canMoveFromTo(x, y, x + dx, y + dy)) {
+                        steps.push_back({x, y, x + dx, y + dy});
+                    }
+                }
+            }
+        }
+    }
+    return steps;
+}
+
+// positions from seeded random games; multi-jumps are played out by the same side
+const std::vector<CheckersBoard> &corpus()
+{
+    static std::vector<CheckersBoard> boards;
+    if (boards.empty()) {
+        std::mt19937 random(20240601);
+        for (int game = 0; game < 32; game++) {
+            CheckersBoard board;
+            int player = CheckersBoard::RED_PLAYER;
+            for (int ply = 0; ply < 200; ply++) {
+                std::vector<Step> steps = legalSteps(board, player);
+                if (steps.empty()) break;
+                boards.push_back(board);
+
+                Step step = steps[random() % steps.size()];
+                CheckersBoard::StepResult result = board.applyStep(step.srcX, step.srcY, step.dstX, step.dstY);
+                while (result.mustContinueJumping) {
+                    std::vector<Step> jumps;
+                    for (const Step &next : legalSteps(board, player)) {
+                        if (next.srcX == step.dstX && next.srcY == step.dstY && board.isJumpMove(next.srcX, next.srcY, next.dstX, next.dstY)) {
+                            jumps.push_back(next);
+                        }
+                    }
+                    if (jumps.empty()) break;
+                    step = jumps[random() % jumps.size()];
+                    result = board.applyStep(step.srcX, step.srcY, step.dstX, step.dstY);
+                }
+                player = 1 - player;
+            }
+        }
+    }
+    return boards;
+}
+
+// both sides of every position, so jump-present and jump-absent boards are mixed
+BENCHMARK("Checkers/hasJumpAvailable", [](bench::State &state) {
+    const std::vector<CheckersBoard> &boards = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        uint64_t jumps = 0;
+        for (const CheckersBoard &board : boards) {
+            jumps += board.hasJumpAvailable(CheckersBoard::RED_PLAYER);
+            jumps += board.hasJumpAvailable(CheckersBoard::YELLOW_PLAYER);
+        }
+        bench::doNotOptimize(jumps);
+        calls += 2 * boards.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+}
@@ -0,0 +1,155 @@
+#include "Bench.h"
+#include "Connect4Board.h"
+#include "Connect4Evaluation.h"
+#include "Connect4Search.h"
+#include "Connect4Solver.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+// move sequences (0-based columns) from the opening to the late middlegame;
+// none of them is already decided, so every search does real work
+const char *CORPUS[] = {
+    "",
+    "3",
+    "33",
+    "3332",
+    "334125",
+    "3324343",
+    "23344552",
+    "3333444",
+    "012345601",
+    "3243342256",
+    "33422413515",
+    "2234455663311",
+    "232212434333",
+    "04330012323133",
+    "335433054301402405",
+    "3333332222224444",
+    "23432542614234340041",
+};
+
+const std::vector<Connect4Board> &corpus()
+{
+    static std::vector<Connect4Board> boards;
+    if (boards.empty()) {
+        for (const char *moves : CORPUS) {
+            Connect4Board board;
+            for (const char *c = moves; *c; c++) {
+                const int col = *c - '0';
+                if (!board.canPlay(col) || board.isWinningMove(col)) {
+                    std::fprintf(stderr, "bad Connect4 corpus line %s\n", moves);
+                    std::abort();
+                }
+                board.play(col);
+            }
+            boards.push_back(board);
+        }
+    }
+    return boards;
+}
+
+// one iteration searches every corpus position to a fixed depth from an empty table,
+// so the node count per iteration is the same on every run
+void searchCorpus(bench::State &state, int depth, int threads)
+{
+    Connect4Search search(1);
+    Connect4SearchLimits limits;
+    limits.maxDepth = depth;
+    limits.threads = threads;
+
+    uint64_t nodes = 0;
+    uint64_t researches = 0;
+    uint64_t failLows = 0;
+    uint64_t failHighs = 0;
+    while (state.keepRunning()) {
+        for (const Connect4Board &board : corpus()) {
+            search.newGame();
+            const Connect4SearchResult result = search.search(board, limits);
+            nodes += result.stats.nodes;
+            researches += result.stats.pvsResearches;
+            failLows += result.stats.aspirationFailLows;
+            failHighs += result.stats.aspirationFailHighs;
+            bench::doNotOptimize((uint64_t)result.move);
+        }
+    }
+    state.setItemsProcessed(nodes);
+    state.setCounter("nodes_per_iteration", (double)nodes / state.iterations());
+    // window tuning data: re-searches per iteration
+    state.setCounter("pvs_researches", (double)researches / state.iterations());
+    state.setCounter("aspiration_fail_lows", (double)failLows / state.iterations());
+    state.setCounter("aspiration_fail_highs", (double)failHighs / state.iterations());
+}
+
+BENCHMARK("Connect4/negamax/depth:6", [](bench::State &state) { searchCorpus(state, 6, 1); });
+BENCHMARK("Connect4/negamax/depth:8", [](bench::State &state) { searchCorpus(state, 8, 1); });
+BENCHMARK("Connect4/negamax/depth:10", [](bench::State &state) { searchCorpus(state, 10, 1); });
+BENCHMARK("Connect4/negamax/depth:12", [](bench::State &state) { searchCorpus(state, 12, 1); });
+
+// Lazy SMP scaling: the same depth with every hardware thread
+BENCHMARK("Connect4/negamax/depth:12/threads:all", [](bench::State &state) {
+    state.setCounter("threads", (double)std::thread::hardware_concurrency());
+    searchCorpus(state, 12, 0);
+});
+
+// exact solve of the later corpus positions from an empty table
+BENCHMARK("Connect4/solve/ply:14+", [](bench::State &state) {
+    Connect4Solver solver(16);
+    uint64_t nodes = 0;
+    while (state.keepRunning()) {
+        for (const Connect4Board &board : corpus()) {
+            if (board.moveCount() < 14)
+                continue;
+            solver.clear();
+            const uint64_t before = solver.nodes();
+            bench::doNotOptimize((uint64_t)solver.solve(board));
+            nodes += solver.nodes() - before;
+        }
+    }
+    state.setItemsProcessed(nodes);
+    state.setCounter("nodes_per_iteration", (double)nodes / state.iterations());
+});
+
+// the terminal check the game runs after every move
+BENCHMARK("Connect4/outcome", [](bench::State &state) {
+    const std::vector<Connect4Board> &boards = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Connect4Board &board : boards) {
+            const Connect4Board::Outcome outcome = board.outcome();
+            bench::doNotOptimize((uint64_t)(outcome.winner + outcome.draw));
+        }
+        calls += boards.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+// the per-turn check the game uses now: only the lines through the last disc
+BENCHMARK("Connect4/lastMoveOutcome", [](bench::State &state) {
+    const std::vector<Connect4Board> &boards = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Connect4Board &board : boards) {
+            const Connect4Board::Outcome outcome = board.lastMoveOutcome();
+            bench::doNotOptimize((uint64_t)(outcome.winner + outcome.draw));
+        }
+        calls += boards.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+// the static evaluation the search calls at every leaf
+BENCHMARK("Connect4/evaluate", [](bench::State &state) {
+    const std::vector<Connect4Board> &boards = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Connect4Board &board : boards)
+            bench::doNotOptimize((uint64_t)Connect4Evaluation::evaluate(board));
+        calls += boards.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+}
@@ -0,0 +1,269 @@
+#include "Bench.h"
+#include "OthelloBoard.h"
+#include "OthelloEvaluation.h"
+#include "OthelloPatterns.h"
+#include "OthelloReferenceBoard.h"
+#include "OthelloSolver.h"
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace {
+
+struct Position
+{
+    OthelloBoard board;
+    int          player;    // side to move, with at least one legal move
+};
+
+// positions from seeded random games, so every run measures the same boards
+const std::vector<Position> &corpus()
+{
+    static std::vector<Position> positions;
+    if (positions.empty()) {
+        std::mt19937 random(20240601);
+        for (int game = 0; game < 16; game++) {
+            OthelloBoard board;
+            int player = OthelloBoard::BLACK_PLAYER;
+            for (;;) {
+                std::vector<std::pair<int, int>> moves = board.getValidMoves(player);
+                if (moves.empty()) {
+                    player = 1 - player;
+                    moves = board.getValidMoves(player);
+                    if (moves.empty()) break;
+                }
+                positions.push_back({board, player});
+                const std::pair<int, int> move = moves[random() % moves.size()];
+                board.play(move.first, move.second, player);
+                player = 1 - player;
+            }
+        }
+    }
+    return positions;
+}
+
+BENCHMARK("Othello/getValidMoves", [](bench::State &state) {
+    const std::vector<Position> &positions = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Position &position : positions) {
+            bench::doNotOptimize(position.board.getValidMoves(position.player).size());
+        }
+        calls += positions.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+// the mask alone, as a search uses it
+BENCHMARK("Othello/legalMoves", [](bench::State &state) {
+    const std::vector<Position> &positions = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Position &position : positions) {
+            bench::doNotOptimize(position.board.legalMoves(position.player));
+        }
+        calls += positions.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+BENCHMARK("Othello/reference/getValidMoves", [](bench::State &state) {
+    std::vector<std::pair<OthelloReferenceBoard, int>> positions;
+    for (const Position &position : corpus()) {
+        OthelloReferenceBoard board;
+        board.setStateString(position.board.stateString());
+        positions.push_back({board, position.player});
+    }
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const auto &position : positions) {
+            bench::doNotOptimize(position.first.getValidMoves(position.second).size());
+        }
+        calls += positions.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+// every legal move of every corpus position, found up front so only the flipping is timed
+std::vector<std::pair<const Position *, std::pair<int, int>>> corpusMoves()
+{
+    std::vector<std::pair<const Position *, std::pair<int, int>>> moves;
+    for (const Position &position : corpus()) {
+        for (const std::pair<int, int> &move : position.board.getValidMoves(position.player)) {
+            moves.push_back({&position, move});
+        }
+    }
+    return moves;
+}
+
+BENCHMARK("Othello/flipPieces", [](bench::State &state) {
+    const auto moves = corpusMoves();
+    uint64_t flips = 0;
+    while (state.keepRunning()) {
+        for (const auto &move : moves) {
+            OthelloBoard board = move.first->board;
+            board.flipPieces(move.second.first, move.second.second, move.first->player);
+            bench::doNotOptimize((uint64_t)board.cellOwner(move.second.first, move.second.second));
+        }
+        flips += moves.size();
+    }
+    state.setItemsProcessed(flips);
+});
+
+BENCHMARK("Othello/reference/flipPieces", [](bench::State &state) {
+    const auto moves = corpusMoves();
+    std::vector<OthelloReferenceBoard> boards;
+    for (const auto &move : moves) {
+        OthelloReferenceBoard board;
+        board.setStateString(move.first->board.stateString());
+        boards.push_back(board);
+    }
+    uint64_t flips = 0;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < moves.size(); i++) {
+            OthelloReferenceBoard board = boards[i];
+            board.flipPieces(moves[i].second.first, moves[i].second.second, moves[i].first->player);
+            bench::doNotOptimize((uint64_t)board.cellOwner(moves[i].second.first, moves[i].second.second));
+        }
+        flips += moves.size();
+    }
+    state.setItemsProcessed(flips);
+});
+
+// exact solves of the corpus positions with 14 empty squares, from an empty table each pass
+BENCHMARK("Othello/solve14", [](bench::State &state) {
+    std::vector<const Position *> positions;
+    for (const Position &position : corpus()) {
+        if (std::popcount(position.board.emptySquares()) == 14) {
+            positions.push_back(&position);
+        }
+    }
+    OthelloSolver solver(16);
+    uint64_t nodes = 0;
+    while (state.keepRunning()) {
+        solver.clear();
+        for (const Position *position : positions) {
+            nodes += solver.bestMove(position->board, position->player).nodes;
+        }
+    }
+    state.setItemsProcessed(nodes);
+});
+
+// the search's leaf evaluation, hand-tuned and from pattern tables
+BENCHMARK("Othello/evaluate", [](bench::State &state) {
+    const std::vector<Position> &positions = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Position &position : positions) {
+            bench::doNotOptimize((uint64_t)OthelloEvaluation::evaluate(position.board.discs(position.player),
+                                                                        position.board.discs(1 - position.player)));
+        }
+        calls += positions.size();
+    }
+    state.setItemsProcessed(calls);
+});
+
+// random weights: only the lookups are timed, not how good the numbers are
+BENCHMARK("Othello/patterns/evaluate", [](bench::State &state) {
+    const std::string path = (std::filesystem::temp_directory_path() / "bench-othello.weights").string();
+    std::mt19937 random(20240601);
+    std::vector<int16_t> weights((size_t)OthelloPatterns::PHASE_COUNT * OthelloPatterns::weightsPerPhase());
+    for (int16_t &weight : weights) weight = (int16_t)(random() % 2001) - 1000;
+    OthelloPatterns patterns;
+    if (!OthelloPatterns::write(path, weights) || !patterns.open(path)) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return;
+    }
+
+    const std::vector<Position> &positions = corpus();
+    uint64_t calls = 0;
+    while (state.keepRunning()) {
+        for (const Position &position : positions) {
+            bench::doNotOptimize((uint64_t)patterns.evaluate(position.board.discs(position.player),
+                                                             position.board.discs(1 - position.player)));
+        }
+        calls += positions.size();
+    }
+    state.setItemsProcessed(calls);
+    patterns.close();
+    std::remove(path.c_str());
+});
+
+// the same work on each move kernel the CPU has, e.g. Othello/avx2/perft
+uint64_t perft(uint64_t own, uint64_t other, int depth)
+{
+    const uint64_t moves = OthelloBoard::legalMoves(own, other);
+    if (depth == 1) return moves ? std::popcount(moves) : OthelloBoard::legalMoves(other, own) != 0;
+    if (!moves) return OthelloBoard::legalMoves(other, own) ? perft(other, own, depth - 1) : 0;
+    uint64_t leaves = 0;
+    for (uint64_t bits = moves; bits; bits &= bits - 1) {
+        const int square = std::countr_zero(bits);
+        const uint64_t flipped = OthelloBoard::flips(own, other, square);
+        leaves += perft(other & ~flipped, own | flipped | (bits & -bits), depth - 1);
+    }
+    return leaves;
+}
+
+// runs body with kernel selected, then puts the startup choice back
+void withKernel(OthelloBoard::Kernel kernel, const std::function<void()> &body)
+{
+    const OthelloBoard::Kernel previous = OthelloBoard::kernel();
+    OthelloBoard::setKernel(kernel);
+    body();
+    OthelloBoard::setKernel(previous);
+}
+
+bool registerKernelBenchmarks()
+{
+    for (int k = 0; k < OthelloBoard::KERNEL_COUNT; k++) {
+        const OthelloBoard::Kernel kernel = (OthelloBoard::Kernel)k;
+        if (!OthelloBoard::kernelSupported(kernel)) continue;
+        const std::string prefix = std::string("Othello/") + OthelloBoard::kernelName(kernel) + "/";
+
+        bench::registerBenchmark(prefix + "legalMoves", [kernel](bench::State &state) {
+            const std::vector<Position> &positions = corpus();
+            uint64_t calls = 0;
+            withKernel(kernel, [&] {
+                while (state.keepRunning()) {
+                    for (const Position &position : positions) {
+                        bench::doNotOptimize(position.board.legalMoves(position.player));
+                    }
+                    calls += positions.size();
+                }
+            });
+            state.setItemsProcessed(calls);
+        });
+        bench::registerBenchmark(prefix + "flips", [kernel](bench::State &state) {
+            const auto moves = corpusMoves();
+            uint64_t calls = 0;
+            withKernel(kernel, [&] {
+                while (state.keepRunning()) {
+                    for (const auto &move : moves) {
+                        const int square = OthelloBoard::square(move.second.first, move.second.second);
+                        bench::doNotOptimize(move.first->board.flips(square, move.first->player));
+                    }
+                    calls += moves.size();
+                }
+            });
+            state.setItemsProcessed(calls);
+        });
+        // leaves of perft 8 from the start, 390,216 per pass
+        bench::registerBenchmark(prefix + "perft", [kernel](bench::State &state) {
+            const OthelloBoard board;
+            uint64_t leaves = 0;
+            withKernel(kernel, [&] {
+                while (state.keepRunning()) {
+                    leaves += perft(board.discs(OthelloBoard::BLACK_PLAYER), board.discs(OthelloBoard::WHITE_PLAYER), 8);
+                }
+            });
+            state.setItemsProcessed(leaves);
+        });
+    }
+    return true;
+}
+
+const bool kernelBenchmarksRegistered = registerKernelBenchmarks();
+
+}
@@ -4,8 +4,6 @@ Checkers::Checkers() : Game() {
     _grid = new Grid(8, 8);
     _mustContinueJumping = false;
     _jumpingPiece = nullptr;
-    _redPieces = 12;
-    _yellowPieces = 12;
 }
 
 Checkers::~Checkers() {
@@ -20,24 +18,15 @@ void Checkers::setUpBoard() {
     // Initialize all squares
     _grid->initializeSquares(80, "boardsquare.png");
 
-    // Enable only dark squares and place pieces
+    // Enable only dark squares
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        bool isDark = (x + y) % 2 == 1;
-        _grid->setEnabled(x, y, isDark);
-
-        if (isDark) {
-            if (y < 3) {
-                Bit* piece = createPiece(RED_PIECE);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            } else if (y > 4) {
-                Bit* piece = createPiece(YELLOW_PIECE);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            }
-        }
+        _grid->setEnabled(x, y, _board.isValidSquare(x, y));
     });
 
+    // place pieces
+    _board = CheckersBoard();
+    syncPieces();
+
     startGame();
 }
 
@@ -52,6 +41,24 @@ Bit* Checkers::createPiece(int pieceType) {
     return bit;
 }
 
+void Checkers::syncPieces() {
+    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
+        square->destroyBit();
+        const int pieceType = _board.pieceAt(x, y);
+        if (pieceType != EMPTY) {
+            Bit* piece = createPiece(pieceType);
+            piece->setPosition(square->getPosition());
+            square->setBit(piece);
+        }
+    });
+}
+
+void Checkers::getBoardPosition(BitHolder &holder, int &x, int &y) const {
+    ChessSquare* square = static_cast<ChessSquare*>(&holder);
+    x = square->getColumn();
+    y = square->getRow();
+}
+
 bool Checkers::actionForEmptyHolder(BitHolder &holder) {
     return false; // Checkers doesn't place new pieces
 }
@@ -60,13 +67,12 @@ bool Checkers::canBitMoveFrom(Bit &bit, BitHolder &src) {
     if (!src.bit() || bit.getOwner() != getCurrentPlayer()) return false;
     if (_mustContinueJumping && &src != _jumpingPiece) return false;
 
-    ChessSquare* square = static_cast<ChessSquare*>(&src);
-    int x = square->getColumn();
-    int y = square->getRow();
+    int x, y;
+    getBoardPosition(src, x, y);
 
     // Must jump if available
-    if (hasJumpAvailable(bit.getOwner())) {
-        return canJumpFrom(*square);
+    if (_board.hasJumpAvailable(bit.getOwner()->playerNumber())) {
+        return _board.canJumpFrom(x, y);
     }
     return true;
 }
@@ -74,88 +80,42 @@ bool Checkers::canBitMoveFrom(Bit &bit, BitHolder &src) {
 bool Checkers::canBitMoveFromTo(Bit& bit, BitHolder& src, BitHolder& dst) {
     if (!src.bit() || dst.bit()) return false;
 
-    ChessSquare* srcSquare = static_cast<ChessSquare*>(&src);
-    ChessSquare* dstSquare = static_cast<ChessSquare*>(&dst);
-
-    int srcX = srcSquare->getColumn();
-    int srcY = srcSquare->getRow();
-
-    if (!_grid->isEnabled(dstSquare->getColumn(), dstSquare->getRow())) return false;
-
-    bool isKing = (bit.gameTag() == RED_KING || bit.gameTag() == YELLOW_KING);
-    bool isRed = (bit.getOwner() == getPlayerAt(RED_PLAYER));
+    int srcX, srcY, dstX, dstY;
+    getBoardPosition(src, srcX, srcY);
+    getBoardPosition(dst, dstX, dstY);
 
-    // Simple moves (if no jumps required)
-    if (!_mustContinueJumping && !hasJumpAvailable(bit.getOwner())) {
-        if (isKing) {
-            return dstSquare == _grid->getFL(srcX, srcY) || dstSquare == _grid->getFR(srcX, srcY) ||
-                   dstSquare == _grid->getBL(srcX, srcY) || dstSquare == _grid->getBR(srcX, srcY);
-        }
-        return isRed ? (dstSquare == _grid->getBL(srcX, srcY) || dstSquare == _grid->getBR(srcX, srcY)) :
-                       (dstSquare == _grid->getFL(srcX, srcY) || dstSquare == _grid->getFR(srcX, srcY));
+    // a jump in progress must be continued by the same piece
+    if (_mustContinueJumping) {
+        int jumperX, jumperY;
+        getBoardPosition(*_jumpingPiece, jumperX, jumperY);
+        return _board.canContinueJump(jumperX, jumperY, srcX, srcY, dstX, dstY);
     }
+    return _board.canMoveFromTo(srcX, srcY, dstX, dstY);
+}
 
-    // Jump moves
-    if (_mustContinueJumping && &src != _jumpingPiece) return false;
+void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
+    int srcX, srcY, dstX, dstY;
+    getBoardPosition(src, srcX, srcY);
+    getBoardPosition(dst, dstX, dstY);
 
-    // Check all jump directions
-    auto checkJump = [&](ChessSquare* middle, ChessSquare* target) -> bool {
-        if (!middle || !target || !middle->bit()) return false;
-        if (middle->bit()->getOwner() == bit.getOwner()) return false;
-        return dstSquare == target;
-    };
+    const CheckersBoard::StepResult step = _board.applyStep(srcX, srcY, dstX, dstY);
 
-    if (isKing || !isRed) {
-        if (checkJump(_grid->getFL(srcX, srcY), _grid->getFLFL(srcX, srcY))) return true;
-        if (checkJump(_grid->getFR(srcX, srcY), _grid->getFRFR(srcX, srcY))) return true;
-    }
-    if (isKing || isRed) {
-        if (checkJump(_grid->getBL(srcX, srcY), _grid->getBLBL(srcX, srcY))) return true;
-        if (checkJump(_grid->getBR(srcX, srcY), _grid->getBRBR(srcX, srcY))) return true;
+    // Capture
+    if (step.captured) {
+        _grid->getSquare(step.capturedX, step.capturedY)->destroyBit();
     }
 
-    return false;
-}
-
-void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
-    ChessSquare* srcSquare = static_cast<ChessSquare*>(&src);
-    ChessSquare* dstSquare = static_cast<ChessSquare*>(&dst);
-
-    int srcX = srcSquare->getColumn();
-    int srcY = srcSquare->getRow();
-    int dstX = dstSquare->getColumn();
-    int dstY = dstSquare->getRow();
-
-    // Check for jump
-    ChessSquare* jumped = nullptr;
-    if (dstSquare == _grid->getFLFL(srcX, srcY)) jumped = _grid->getFL(srcX, srcY);
-    else if (dstSquare == _grid->getFRFR(srcX, srcY)) jumped = _grid->getFR(srcX, srcY);
-    else if (dstSquare == _grid->getBLBL(srcX, srcY)) jumped = _grid->getBL(srcX, srcY);
-    else if (dstSquare == _grid->getBRBR(srcX, srcY)) jumped = _grid->getBR(srcX, srcY);
-
-    if (jumped && jumped->bit()) {
-        // Capture
-        (jumped->bit()->getOwner() == getPlayerAt(RED_PLAYER)) ? _redPieces-- : _yellowPieces--;
-        jumped->destroyBit();
-
-        // Promotion check
-        if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
-            bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
-            bit.setScale(1.3f);
-        }
+    // Promotion
+    if (step.promoted) {
+        bit.setGameTag(_board.pieceAt(dstX, dstY));
+        bit.setScale(1.3f);
+    }
 
-        // Check for more jumps
-        if (canJumpFrom(*dstSquare)) {
-            _mustContinueJumping = true;
-            _jumpingPiece = &dst;
-            return;
-        }
-    } else {
-        // Regular move - promotion check
-        if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
-            bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
-            bit.setScale(1.3f);
-        }
+    // Check for more jumps
+    if (step.mustContinueJumping) {
+        _mustContinueJumping = true;
+        _jumpingPiece = &dst;
+        return;
     }
 
     _mustContinueJumping = false;
@@ -163,83 +123,15 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     endTurn();
 }
 
-bool Checkers::canJumpFrom(ChessSquare& square) const {
-    Bit* piece = square.bit();
-    if (!piece) return false;
-
-    int x = square.getColumn();
-    int y = square.getRow();
-    bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-    bool isRed = (piece->getOwner() == getPlayerAt(RED_PLAYER));
-    Player* player = piece->getOwner();
-
-    auto checkJumpDir = [&](ChessSquare* middle, ChessSquare* target) -> bool {
-        return middle && middle->bit() && middle->bit()->getOwner() != player &&
-               target && !target->bit();
-    };
-
-    if (isKing || !isRed) {
-        if (checkJumpDir(_grid->getFL(x, y), _grid->getFLFL(x, y))) return true;
-        if (checkJumpDir(_grid->getFR(x, y), _grid->getFRFR(x, y))) return true;
-    }
-    if (isKing || isRed) {
-        if (checkJumpDir(_grid->getBL(x, y), _grid->getBLBL(x, y))) return true;
-        if (checkJumpDir(_grid->getBR(x, y), _grid->getBRBR(x, y))) return true;
-    }
-    return false;
-}
-
-bool Checkers::hasJumpAvailable(Player* player) const {
-    bool hasJump = false;
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasJump) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == player) {
-            Checkers* self = const_cast<Checkers*>(this);
-            if (self->canJumpFrom(*square)) {
-                hasJump = true;
-            }
-        }
-    });
-    return hasJump;
-}
-
 Player* Checkers::checkForWinner() {
-    if (_redPieces == 0) return getPlayerAt(YELLOW_PLAYER);
-    if (_yellowPieces == 0) return getPlayerAt(RED_PLAYER);
+    int redPieces, yellowPieces;
+    _board.countPieces(redPieces, yellowPieces);
+    if (redPieces == 0) return getPlayerAt(YELLOW_PLAYER);
+    if (yellowPieces == 0) return getPlayerAt(RED_PLAYER);
 
     // Check if current player has any moves
     Player* current = getCurrentPlayer();
-    bool hasMove = false;
-
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasMove) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == current) {
-            bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-            bool isRed = (current == getPlayerAt(RED_PLAYER));
-
-            // Check for any valid move
-            auto checkMove = [&](ChessSquare* target) {
-                if (target && !target->bit()) hasMove = true;
-            };
-
-            if (isKing) {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else if (isRed) {
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-            }
-        }
-    });
-
-    if (!hasMove) {
+    if (!_board.hasAnyMove(current->playerNumber())) {
         return current == getPlayerAt(RED_PLAYER) ? getPlayerAt(YELLOW_PLAYER) : getPlayerAt(RED_PLAYER);
     }
     return nullptr;
@@ -255,40 +147,21 @@ void Checkers::stopGame() {
     });
     _mustContinueJumping = false;
     _jumpingPiece = nullptr;
-    _redPieces = 12;
-    _yellowPieces = 12;
 }
 
 std::string Checkers::initialStateString() {
-    return "111111111111--------333333333333";
+    return CheckersBoard().stateString();
 }
 
 std::string Checkers::stateString() {
-    return _grid->getStateString();
+    return _board.stateString();
 }
 
 void Checkers::setStateString(const std::string &s) {
-    if (s.length() != 32) return;
-
-    _redPieces = 0;
-    _yellowPieces = 0;
-
-    _grid->setStateString(s);
+    if (!_board.setStateString(s)) return;
 
     // Recreate pieces from state
-    size_t index = 0;
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (index < s.length()) {
-            int pieceType = s[index++] - '0';
-            if (pieceType != 0) {
-                Bit* piece = createPiece(pieceType);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-                (pieceType == RED_PIECE || pieceType == RED_KING) ? _redPieces++ : _yellowPieces++;
-            }
-        }
-    });
+    syncPieces();
 }
 
 void Checkers::updateAI() {}
-
@@ -1,5 +1,6 @@
 #pragma once
 #include "Game.h"
+#include "CheckersBoard.h"
 
 // NOTE: If Square class needs modifications to support colored squares for checkerboard pattern,
 // add a method like setColor(ImVec4 color) to Square class
@@ -30,35 +31,27 @@ public:
 
 private:
     // Constants for piece types
-    static const int EMPTY = 0;
-    static const int RED_PIECE = 1;
-    static const int RED_KING = 2;
-    static const int YELLOW_PIECE = 3;
-    static const int YELLOW_KING = 4;
+    static const int EMPTY = CheckersBoard::EMPTY;
+    static const int RED_PIECE = CheckersBoard::RED_PIECE;
+    static const int RED_KING = CheckersBoard::RED_KING;
+    static const int YELLOW_PIECE = CheckersBoard::YELLOW_PIECE;
+    static const int YELLOW_KING = CheckersBoard::YELLOW_KING;
 
     // Player constants
-    static const int RED_PLAYER = 0;
-    static const int YELLOW_PLAYER = 1;
+    static const int RED_PLAYER = CheckersBoard::RED_PLAYER;
+    static const int YELLOW_PLAYER = CheckersBoard::YELLOW_PLAYER;
 
     // Helper methods
     Bit*        createPiece(int pieceType);
-    int         getPieceType(const Bit& bit) const;
-    bool        isKing(const Bit& bit) const;
-    bool        isValidMove(int srcX, int srcY, int dstX, int dstY, Player* player) const;
-    bool        isJumpMove(int srcX, int srcY, int dstX, int dstY) const;
-    bool        hasJumpAvailable(Player* player) const;
-    bool        canJumpFrom(ChessSquare& square) const;
-    void        performJump(int srcX, int srcY, int dstX, int dstY);
-    void        promoteToKing(Bit& bit, int y);
+    // rebuild the sprites on the grid from _board
+    void        syncPieces();
     void        getBoardPosition(BitHolder &holder, int &x, int &y) const;
-    bool        isValidSquare(int x, int y) const;
 
-    // Board representation
+    // Board representation: _board holds the rules state, _grid only draws it
     Grid*        _grid;
+    CheckersBoard _board;
 
     // Game state
     bool        _mustContinueJumping;
     BitHolder*  _jumpingPiece;
-    int         _redPieces;
-    int         _yellowPieces;
 };
\ No newline at end of file
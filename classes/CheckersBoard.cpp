@@ -0,0 +1,183 @@
+#include "CheckersBoard.h"
+#include <cstdlib>
+
+CheckersBoard::CheckersBoard()
+{
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            int piece = EMPTY;
+            if (isValidSquare(x, y)) {
+                if (y < 3) {
+                    piece = RED_PIECE;
+                } else if (y > 4) {
+                    piece = YELLOW_PIECE;
+                }
+            }
+            setPiece(x, y, piece);
+        }
+    }
+}
+
+bool CheckersBoard::setStateString(const std::string &s)
+{
+    if (s.length() != 32) return false;
+    for (char c : s) {
+        if (c < '0' || c > '4') return false;
+    }
+
+    size_t index = 0;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            setPiece(x, y, isValidSquare(x, y) ? s[index++] - '0' : EMPTY);
+        }
+    }
+    return true;
+}
+
+std::string CheckersBoard::stateString() const
+{
+    std::string state;
+    state.reserve(32);
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (isValidSquare(x, y)) {
+                state += (char)('0' + pieceAt(x, y));
+            }
+        }
+    }
+    return state;
+}
+
+bool CheckersBoard::canStepToward(int piece, int dy) const
+{
+    if (isKing(piece)) return true;
+    return ownerOf(piece) == RED_PLAYER ? dy > 0 : dy < 0;
+}
+
+bool CheckersBoard::canJumpFrom(int x, int y) const
+{
+    const int piece = pieceAt(x, y);
+    if (piece == EMPTY) return false;
+
+    const int player = ownerOf(piece);
+    for (int dy = -1; dy <= 1; dy += 2) {
+        if (!canStepToward(piece, dy)) continue;
+        for (int dx = -1; dx <= 1; dx += 2) {
+            const int mx = x + dx, my = y + dy;
+            const int tx = x + 2 * dx, ty = y + 2 * dy;
+            if (!isValidSquare(tx, ty)) continue;
+            const int middle = pieceAt(mx, my);
+            if (middle != EMPTY && ownerOf(middle) != player && pieceAt(tx, ty) == EMPTY) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CheckersBoard::hasJumpAvailable(int player) const
+{
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (ownerOf(pieceAt(x, y)) == player && canJumpFrom(x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CheckersBoard::isJumpMove(int srcX, int srcY, int dstX, int dstY) const
+{
+    return std::abs(dstX - srcX) == 2 && std::abs(dstY - srcY) == 2;
+}
+
+bool CheckersBoard::canMoveFromTo(int srcX, int srcY, int dstX, int dstY) const
+{
+    if (!isValidSquare(srcX, srcY) || !isValidSquare(dstX, dstY)) return false;
+
+    const int piece = pieceAt(srcX, srcY);
+    if (piece == EMPTY || pieceAt(dstX, dstY) != EMPTY) return false;
+
+    const int dx = dstX - srcX;
+    const int dy = dstY - srcY;
+    if (!canStepToward(piece, dy)) return false;
+
+    // Simple moves (if no jumps required)
+    if (std::abs(dx) == 1 && std::abs(dy) == 1) {
+        return !hasJumpAvailable(ownerOf(piece));
+    }
+
+    // Jump moves
+    if (isJumpMove(srcX, srcY, dstX, dstY)) {
+        const int middle = pieceAt(srcX + dx / 2, srcY + dy / 2);
+        return middle != EMPTY && ownerOf(middle) != ownerOf(piece);
+    }
+    return false;
+}
+
+bool CheckersBoard::canContinueJump(int jumperX, int jumperY, int srcX, int srcY, int dstX, int dstY) const
+{
+    if (srcX != jumperX || srcY != jumperY) return false;
+    return isJumpMove(srcX, srcY, dstX, dstY) && canMoveFromTo(srcX, srcY, dstX, dstY);
+}
+
+bool CheckersBoard::hasAnyMove(int player) const
+{
+    if (hasJumpAvailable(player)) return true;
+
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            const int piece = pieceAt(x, y);
+            if (ownerOf(piece) != player) continue;
+            for (int dy = -1; dy <= 1; dy += 2) {
+                if (!canStepToward(piece, dy)) continue;
+                for (int dx = -1; dx <= 1; dx += 2) {
+                    if (isValidSquare(x + dx, y + dy) && pieceAt(x + dx, y + dy) == EMPTY) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+CheckersBoard::StepResult CheckersBoard::applyStep(int srcX, int srcY, int dstX, int dstY)
+{
+    StepResult result = {false, -1, -1, false, false};
+    int piece = pieceAt(srcX, srcY);
+    setPiece(srcX, srcY, EMPTY);
+
+    if (isJumpMove(srcX, srcY, dstX, dstY)) {
+        result.captured = true;
+        result.capturedX = (srcX + dstX) / 2;
+        result.capturedY = (srcY + dstY) / 2;
+        setPiece(result.capturedX, result.capturedY, EMPTY);
+    }
+
+    // Promotion check
+    if ((piece == RED_PIECE && dstY == SIZE - 1) || (piece == YELLOW_PIECE && dstY == 0)) {
+        piece = piece == RED_PIECE ? RED_KING : YELLOW_KING;
+        result.promoted = true;
+    }
+    setPiece(dstX, dstY, piece);
+
+    // Check for more jumps
+    result.mustContinueJumping = result.captured && canJumpFrom(dstX, dstY);
+    return result;
+}
+
+void CheckersBoard::countPieces(int &redCount, int &yellowCount) const
+{
+    redCount = 0;
+    yellowCount = 0;
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        const int owner = ownerOf(_cells[i]);
+        if (owner == RED_PLAYER) {
+            redCount++;
+        } else if (owner == YELLOW_PLAYER) {
+            yellowCount++;
+        }
+    }
+}
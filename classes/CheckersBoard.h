@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//
+// checkers rules on a plain 8x8 array, independent of the UI
+//
+// red starts on rows 0-2 and moves down the board (increasing y); yellow starts
+// on rows 5-7 and moves up. only dark squares ((x + y) odd) are playable, and
+// the state string lists those 32 squares row-major with one piece-type digit each.
+//
+class CheckersBoard
+{
+public:
+    static const int SIZE = 8;
+
+    // Constants for piece types
+    static const int EMPTY = 0;
+    static const int RED_PIECE = 1;
+    static const int RED_KING = 2;
+    static const int YELLOW_PIECE = 3;
+    static const int YELLOW_KING = 4;
+
+    // Player constants
+    static const int RED_PLAYER = 0;
+    static const int YELLOW_PLAYER = 1;
+
+    // what one step (a simple move or a single jump) did to the board
+    struct StepResult {
+        bool captured;
+        int  capturedX;
+        int  capturedY;
+        bool promoted;
+        bool mustContinueJumping;  // the same piece has another jump available
+    };
+
+    // standard starting position
+    CheckersBoard();
+
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+    int         pieceAt(int x, int y) const { return _cells[y * SIZE + x]; }
+    bool        isValidSquare(int x, int y) const { return x >= 0 && x < SIZE && y >= 0 && y < SIZE && (x + y) % 2 == 1; }
+
+    static int  ownerOf(int piece) { return piece == EMPTY ? -1 : (piece <= RED_KING ? RED_PLAYER : YELLOW_PLAYER); }
+    static bool isKing(int piece) { return piece == RED_KING || piece == YELLOW_KING; }
+
+    bool        canJumpFrom(int x, int y) const;
+    bool        hasJumpAvailable(int player) const;
+    bool        isJumpMove(int srcX, int srcY, int dstX, int dstY) const;
+    // legal single step for the piece on (srcX, srcY), including the forced-capture rule
+    bool        canMoveFromTo(int srcX, int srcY, int dstX, int dstY) const;
+    // legal step while the piece on (jumperX, jumperY) is partway through a jump sequence:
+    // only that piece may move, and only by jumping again
+    bool        canContinueJump(int jumperX, int jumperY, int srcX, int srcY, int dstX, int dstY) const;
+    // the player has at least one legal step
+    bool        hasAnyMove(int player) const;
+    // apply a step already checked with canMoveFromTo
+    StepResult  applyStep(int srcX, int srcY, int dstX, int dstY);
+    void        countPieces(int &redCount, int &yellowCount) const;
+
+private:
+    // the two forward diagonals for a piece; kings use both directions
+    bool        canStepToward(int piece, int dy) const;
+    void        setPiece(int x, int y, int piece) { _cells[y * SIZE + x] = (int8_t)piece; }
+
+    int8_t      _cells[SIZE * SIZE];
+};
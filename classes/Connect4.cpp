@@ -1,209 +1,21 @@
 #include "Connect4.h"
-#include <limits>
-#include <vector>
 
-namespace {
-int boardIndex(int x, int y, int width)
+Connect4::Connect4(bool enableAI, int aiPlayerNumber, int variant)
+    : Game(), _enableAI(enableAI), _aiPlayerNumber(aiPlayerNumber),
+      _engine(Connect4Engine::variant(variant).create()), _outcomeMoveCount(-1), _pondered(false),
+      _width(_engine->width()), _height(_engine->height())
 {
-    return y * width + x;
-}
-
-int nextPlayerNumber(int playerNumber)
-{
-    return 1 - playerNumber;
-}
-
-bool boardFull(const std::vector<int> &board)
-{
-    for (int cell : board) {
-        if (cell == 0) {
-            return false;
-        }
-    }
-    return true;
-}
-
-bool hasFourInARow(const std::vector<int> &board, int width, int height, int playerNumber)
-{
-    const int token = playerNumber + 1;
-    const int dirs[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            if (board[boardIndex(x, y, width)] != token) {
-                continue;
-            }
-
-            for (int di = 0; di < 4; di++) {
-                int nx = x;
-                int ny = y;
-                int count = 1;
-                const int dx = dirs[di][0];
-                const int dy = dirs[di][1];
-                for (int k = 1; k < 4; k++) {
-                    nx += dx;
-                    ny += dy;
-                    if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
-                        break;
-                    }
-                    if (board[boardIndex(nx, ny, width)] != token) {
-                        break;
-                    }
-                    count++;
-                }
-                if (count >= 4) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
-}
-
-struct BoardOutcome {
-    int winnerToken; // 0 = none, 1/2 = player token
-    bool draw;
-};
-
-BoardOutcome evaluateBoardOutcome(const std::vector<int> &board, int width, int height)
-{
-    bool full = true;
-    const int dirs[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            const int token = board[boardIndex(x, y, width)];
-            if (token == 0) {
-                full = false;
-                continue;
-            }
-
-            for (int di = 0; di < 4; di++) {
-                int nx = x;
-                int ny = y;
-                int count = 1;
-                const int dx = dirs[di][0];
-                const int dy = dirs[di][1];
-                for (int k = 1; k < 4; k++) {
-                    nx += dx;
-                    ny += dy;
-                    if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
-                        break;
-                    }
-                    if (board[boardIndex(nx, ny, width)] != token) {
-                        break;
-                    }
-                    count++;
-                }
-                if (count >= 4) {
-                    return {token, false};
-                }
-            }
-        }
-    }
-
-    return {0, full};
-}
-
-int getDropRow(const std::vector<int> &board, int width, int height, int column)
-{
-    for (int row = height - 1; row >= 0; row--) {
-        if (board[boardIndex(column, row, width)] == 0) {
-            return row;
-        }
-    }
-    return -1;
-}
-
-bool applyMove(std::vector<int> &board, int width, int height, int column, int playerNumber)
-{
-    const int row = getDropRow(board, width, height, column);
-    if (row < 0) {
-        return false;
-    }
-    board[boardIndex(column, row, width)] = playerNumber + 1;
-    return true;
-}
-
-int evaluateBoardState(const std::vector<int> &board, int width, int height, int aiPlayer)
-{
-    const int opponent = nextPlayerNumber(aiPlayer);
-    if (hasFourInARow(board, width, height, aiPlayer)) {
-        return 100000;
-    }
-    if (hasFourInARow(board, width, height, opponent)) {
-        return -100000;
-    }
-
-    // Mild center preference so early moves are less random.
-    int score = 0;
-    const int center = width / 2;
-    for (int y = 0; y < height; y++) {
-        int cell = board[boardIndex(center, y, width)];
-        if (cell == aiPlayer + 1) {
-            score += 3;
-        } else if (cell == opponent + 1) {
-            score -= 3;
-        }
-    }
-    return score;
-}
-int negamax(const std::vector<int> &board,
-            int width, int height,
-            int depth,
-            int turnPlayer,
-            int aiPlayer,
-            int alpha, int beta)
-{
-    const int opponent = nextPlayerNumber(aiPlayer);
-
-    // terminal / cutoff
-    if (depth == 0 ||
-        hasFourInARow(board, width, height, turnPlayer) ||
-        hasFourInARow(board, width, height, opponent) ||
-        boardFull(board)) {
-        return evaluateBoardState(board, width, height, turnPlayer);
-    }
-
-    int best = std::numeric_limits<int>::min();
-    bool foundMove = false;
-
-    for (int col = 0; col < width; col++) {
-        std::vector<int> nextBoard = board;
-        if (!applyMove(nextBoard, width, height, col, turnPlayer)) {
-            continue;
-        }
-        foundMove = true;
-
-        // Negamax: score = - negamax(next, otherTurn, -beta, -alpha)
-        int score = -negamax(nextBoard,
-                             width, height,
-                             depth - 1,
-                             nextPlayerNumber(turnPlayer),
-                             aiPlayer,
-                             -beta, -alpha);
-
-        best = std::max(best, score);
-        alpha = std::max(alpha, best);
-        if (alpha >= beta) break; // alpha-beta cutoff
-    }
-
-    if (!foundMove) {
-        return evaluateBoardState(board, width, height, aiPlayer);
-    }
-    return best;
-}
-
-}
-
-Connect4::Connect4(bool enableAI, int aiPlayerNumber)
-    : Game(), _enableAI(enableAI), _aiPlayerNumber(aiPlayerNumber)
-{
-    _grid = new Grid(WIDTH, HEIGHT);
+    _grid = new Grid(_width, _height);
+    // built offline by the c4book and c4endgame tools; without them every move is searched
+    _book.open("resources/connect4.book");
+    if (_endgame.open("resources/connect4.endgame"))
+        _engine->setEndgame(&_endgame);
 }
 
 Connect4::~Connect4()
 {
+    // the worker may still be using the engine
+    cancelAISearch();
     delete _grid;
 }
 
@@ -224,10 +36,12 @@ void Connect4::setUpBoard()
     getPlayerAt(0)->setName("Red");
     getPlayerAt(1)->setName("Yellow");
 
-    _gameOptions.rowX = WIDTH;
-    _gameOptions.rowY = HEIGHT;
+    _gameOptions.rowX = _width;
+    _gameOptions.rowY = _height;
 
     _grid->initializeSquares(80, "square.png");
+    _engine->newGame();
+    _outcomeMoveCount = -1;
 
     if (gameHasAI()) {
         if (_aiPlayerNumber < 0 || _aiPlayerNumber >= 2) {
@@ -244,53 +58,6 @@ bool Connect4::isAITurn()
     return gameHasAI() && getCurrentPlayer()->isAIPlayer();
 }
 
-int Connect4::currentPlayer()
-{
-    return _players.at(_gameOptions.currentTurnNo & 1)->playerNumber();
-}
-
-std::vector<int> Connect4::snapshotBoard() const
-{
-    std::vector<int> board(WIDTH * HEIGHT, 0);
-    for (int y = 0; y < HEIGHT; y++) {
-        for (int x = 0; x < WIDTH; x++) {
-            Player *owner = ownerAt(x, y);
-            if (owner) {
-                board[boardIndex(x, y, WIDTH)] = owner->playerNumber() + 1;
-            }
-        }
-    }
-    return board;
-}
-
-int Connect4::findBestMove(int depth, int aiPlayer)
-{
-    std::vector<int> board = snapshotBoard();
-
-    int bestCol = -1;
-    int bestScore = std::numeric_limits<int>::min();
-    for (int col = 0; col < WIDTH; col++) {
-        std::vector<int> nextBoard = board;
-        if (!applyMove(nextBoard, WIDTH, HEIGHT, col, aiPlayer)) {
-            continue;
-        }
-        int score = -negamax(
-            nextBoard,
-            WIDTH,
-            HEIGHT,
-            depth - 1,
-            nextPlayerNumber(aiPlayer),
-            aiPlayer,
-            std::numeric_limits<int>::min(),
-            std::numeric_limits<int>::max());
-        if (score > bestScore) {
-            bestScore = score;
-            bestCol = col;
-        }
-    }
-    return bestCol;
-}
-
 bool Connect4::dropInColumn(int column)
 {
     ChessSquare *top = _grid->getSquare(column, 0);
@@ -302,27 +69,28 @@ bool Connect4::dropInColumn(int column)
 
 bool Connect4::dropPieceAtColumn(int column)
 {
-    if (column < 0 || column >= WIDTH)
+    if (column < 0 || column >= _width || !_engine->canPlay(column))
         return false;
 
-    // search from bottom row upward for the first empty spot
-    for (int row = HEIGHT - 1; row >= 0; row--) {
-        ChessSquare *sq = _grid->getSquare(column, row);
-        if (sq && !sq->bit()) {
-            Bit *bit = PieceForPlayer(getCurrentPlayer()->playerNumber());
-            // start above the board so we can animate dropping
-            ImVec2 target = sq->getPosition();
-            ImVec2 startPos = target;
-            startPos.y -= 200; // arbitrary distance above
-            bit->setPosition(startPos);
-            sq->setBit(bit);
-            // animate into place
-            bit->moveTo(target);
-            endTurn();
-            return true;
-        }
-    }
-    return false;
+    // grid rows count down from the top, board rows up from the bottom
+    ChessSquare *sq = _grid->getSquare(column, _height - 1 - _engine->columnHeight(column));
+    if (!sq)
+        return false;
+
+    // the ponder job searches with the engine, and this move ends the turn it pondered on
+    stopPonder();
+    _engine->play(column);
+    Bit *bit = PieceForPlayer(getCurrentPlayer()->playerNumber());
+    // start above the board so we can animate dropping
+    ImVec2 target = sq->getPosition();
+    ImVec2 startPos = target;
+    startPos.y -= 200; // arbitrary distance above
+    bit->setPosition(startPos);
+    sq->setBit(bit);
+    // animate into place
+    bit->moveTo(target);
+    endTurn();
+    return true;
 }
 
 bool Connect4::actionForEmptyHolder(BitHolder &holder)
@@ -332,68 +100,89 @@ bool Connect4::actionForEmptyHolder(BitHolder &holder)
     return dropPieceAtColumn(col);
 }
 
-Player* Connect4::ownerAt(int x, int y) const
+const Connect4Outcome &Connect4::outcome()
 {
-    ChessSquare *sq = _grid->getSquare(x, y);
-    if (!sq || !sq->bit())
-        return nullptr;
-    return sq->bit()->getOwner();
+    if (_outcomeMoveCount != _engine->moveCount()) {
+        _outcome = _engine->lastMoveOutcome();
+        _outcomeMoveCount = _engine->moveCount();
+    }
+    return _outcome;
 }
 
 Player* Connect4::checkForWinner()
 {
-    const std::vector<int> board = snapshotBoard();
-    const BoardOutcome outcome = evaluateBoardOutcome(board, WIDTH, HEIGHT);
-    if (outcome.winnerToken > 0) {
-        return getPlayerAt(outcome.winnerToken - 1);
-    }
-    return nullptr;
+    return outcome().winner >= 0 ? getPlayerAt(outcome().winner) : nullptr;
 }
 
 bool Connect4::checkForDraw()
 {
-    const std::vector<int> board = snapshotBoard();
-    const BoardOutcome outcome = evaluateBoardOutcome(board, WIDTH, HEIGHT);
-    return outcome.draw;
+    return outcome().winner < 0 && outcome().draw;
+}
+
+GameOutcome Connect4::checkForOutcome()
+{
+    GameOutcome result;
+    result.winner = checkForWinner();
+    result.draw = checkForDraw();
+    return result;
+}
+
+void Connect4::ponderAI()
+{
+    if (!gameHasAI() || isAITurn() || ponderRunning() || _pondered)
+        return;
+    if (outcome().winner >= 0 || outcome().draw)
+        return;
+
+    Connect4SearchLimits limits;
+    // pondering runs on the opponent's time, so it keeps to its own thread count
+    limits.threads = _gameOptions.AIPonderThreads;
+    Connect4Engine::MoveJob job = _engine->ponderJob(limits, _gameOptions.AIPerfectPlay);
+    if (job) {
+        _pondered = startPonder(job);
+    }
 }
 
 void Connect4::stopGame()
 {
+    cancelAISearch();
+    _pondered = false;
     _grid->forEachSquare([](ChessSquare *square, int x, int y) {
         square->destroyBit();
     });
+    _engine->newGame();
+    _outcomeMoveCount = -1;
 }
 
 std::string Connect4::initialStateString()
 {
-    return std::string(WIDTH * HEIGHT, '0');
+    return std::string(_width * _height, '0');
 }
 
 std::string Connect4::stateString()
 {
-    std::string s;
-    s.reserve(WIDTH * HEIGHT);
-    _grid->forEachSquare([&s](ChessSquare *square, int x, int y) {
-        Bit *bit = square->bit();
-        if (!bit)
-            s += '0';
-        else
-            s += std::to_string(bit->getOwner()->playerNumber() + 1)[0];
-    });
-    return s;
+    return _engine->stateString();
 }
 
 void Connect4::setStateString(const std::string &s)
 {
-    if ((int)s.length() != WIDTH * HEIGHT)
+    const std::string previous = _engine->stateString();
+    if (!_engine->setStateString(s))
         return;
+    // the turn number picks the player to move, so it follows the loaded position;
+    // a position whose side to move no player would get is put back
+    const int moves = _engine->moveCount();
+    if ((size_t)(moves & 1) >= _players.size() || getPlayerAt(moves & 1)->playerNumber() != (moves & 1)) {
+        _engine->setStateString(previous);
+        return;
+    }
+    _gameOptions.currentTurnNo = moves;
+    _outcomeMoveCount = -1;
 
-    int idx = 0;
     _grid->forEachSquare([&](ChessSquare *square, int x, int y) {
-        char c = s[idx++];
         square->destroyBit();
-        if (c == '1' || c == '2') {
-            int player = (c - '1');
+        const int player = _engine->cellOwner(x, _height - 1 - y);
+        if (player >= 0) {
             Bit *bit = PieceForPlayer(player);
             bit->setPosition(square->getPosition());
             square->setBit(bit);
@@ -408,9 +197,44 @@ void Connect4::updateAI()
     if (!isAITurn())
         return;
 
-    int turnPlayer = currentPlayer();
-    int bestCol = findBestMove(DEPTH, turnPlayer);
-    if (bestCol >= 0) {
-        dropInColumn(bestCol);
+    // the search runs on a worker thread so frames keep drawing while it thinks
+    int bestCol = -1;
+    if (pollAISearch(bestCol)) {
+        if (bestCol >= 0) {
+            dropInColumn(bestCol);
+        }
+        return;
+    }
+    if (!aiSearchRunning()) {
+        stopPonder();
+        const bool pondered = _pondered;
+        _pondered = false;
+
+        // the early plies are the same in every game, so take them from the book
+        int column;
+        if (_engine->bookMove(_book, column)) {
+            dropInColumn(column);
+            return;
+        }
+
+        // when the reply was pondered for at least a move's budget its answer is ready;
+        // otherwise the search below still starts from the table pondering filled
+        if (pondered) {
+            SearchStats stats;
+            const bool hit = _engine->ponderedMove(getAITimeBudgetMs(), column, stats);
+            recordPonderOutcome(hit);
+            if (hit) {
+                recordSearchStats(stats);
+                dropInColumn(column);
+                return;
+            }
+        }
+
+        Connect4SearchLimits limits;
+        limits.timeBudgetMs = getAITimeBudgetMs();
+        limits.threads = _gameOptions.AIThreads;
+        startAISearch(_engine->moveJob(limits, _gameOptions.AIPerfectPlay, [this](const SearchStats &stats) {
+            recordSearchStats(stats);
+        }));
     }
 }
@@ -1,17 +1,20 @@
 #pragma once
 #include "Game.h"
-#include <vector>
+#include "Connect4Book.h"
+#include "Connect4Engine.h"
+#include <memory>
 
-// Connect Four implementation
+// Connect Four implementation; variant indexes Connect4Engine::variant() for the board size
 class Connect4 : public Game
 {
 public:
-    explicit Connect4(bool enableAI = true, int aiPlayerNumber = AI_PLAYER);
+    explicit Connect4(bool enableAI = true, int aiPlayerNumber = AI_PLAYER, int variant = 0);
     ~Connect4();
 
     void        setUpBoard() override;
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
+    GameOutcome checkForOutcome() override;
     std::string initialStateString() override;
     std::string stateString() override;
     void        setStateString(const std::string &s) override;
@@ -22,23 +25,29 @@ public:
 
     bool        gameHasAI() override { return _enableAI; }
     void        updateAI() override;
+    void        ponderAI() override;
     Grid*       getGrid() override { return _grid; }
 
 private:
     bool        isAITurn();
-    int         currentPlayer();
-    int         findBestMove(int depth, int aiPlayer);
     bool        dropInColumn(int column);
-    std::vector<int> snapshotBoard() const;
+    // result after the latest move, recomputed only when the move count changes
+    const Connect4Outcome &outcome();
 
     Bit*        PieceForPlayer(int playerNumber);
     bool        dropPieceAtColumn(int column);
-    Player*     ownerAt(int x, int y) const;
 
     Grid*       _grid;
     bool        _enableAI;
     int         _aiPlayerNumber;
-    static const int DEPTH = 5;
-    static const int WIDTH = 7;
-    static const int HEIGHT = 6;
+    // board, search and solver for the chosen size; the board mirrors the grid and
+    // is updated as each disc is dropped
+    std::unique_ptr<Connect4Engine> _engine;
+    Connect4Outcome _outcome;
+    int         _outcomeMoveCount;  // move count _outcome was computed for, -1 if stale
+    Connect4Book _book;         // empty when no book file ships with the game
+    Connect4Endgame _endgame;   // likewise for the endgame database
+    bool        _pondered;      // a ponder job ran since the AI last moved
+    const int   _width;
+    const int   _height;
 };
@@ -0,0 +1,121 @@
+#include "Connect4Board.h"
+
+template <int W, int H>
+BasicConnect4Board<W, H>::BasicConnect4Board()
+{
+    _stones[0] = 0;
+    _stones[1] = 0;
+    for (int col = 0; col < WIDTH; col++) {
+        _height[col] = col * (HEIGHT + 1);
+    }
+    _moves = 0;
+    _lastColumn = -1;
+}
+
+template <int W, int H>
+bool BasicConnect4Board<W, H>::setStateString(const std::string &s)
+{
+    if ((int)s.length() != CELLS)
+        return false;
+
+    BasicConnect4Board board;
+    for (int col = 0; col < WIDTH; col++) {
+        // walk the column bottom-up; once we hit an empty cell everything above must be empty too
+        bool empty = false;
+        for (int row = 0; row < HEIGHT; row++) {
+            const char c = s[(HEIGHT - 1 - row) * WIDTH + col];
+            if (c == '0') {
+                empty = true;
+                continue;
+            }
+            if ((c != '1' && c != '2') || empty)
+                return false;
+            board._stones[c - '1'] |= Bitboard(1) << board._height[col]++;
+            board._moves++;
+        }
+    }
+    // the side to move is read from the parity of the disc count
+    const int lead = popcount(board._stones[0]) - popcount(board._stones[1]);
+    if (lead != 0 && lead != 1)
+        return false;
+    *this = board;
+    return true;
+}
+
+template <int W, int H>
+std::string BasicConnect4Board<W, H>::stateString() const
+{
+    std::string s;
+    s.reserve(CELLS);
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            const int owner = cellOwner(x, HEIGHT - 1 - y);
+            s += owner < 0 ? '0' : (char)('1' + owner);
+        }
+    }
+    return s;
+}
+
+template <int W, int H>
+Connect4Outcome BasicConnect4Board<W, H>::outcome() const
+{
+    if (hasFour(_stones[0]))
+        return {0, false};
+    if (hasFour(_stones[1]))
+        return {1, false};
+    return {-1, isFull()};
+}
+
+template <int W, int H>
+Connect4Outcome BasicConnect4Board<W, H>::lastMoveOutcome() const
+{
+    if (_lastColumn < 0)
+        return outcome();
+
+    // the disc on top of the last column belongs to whoever moved before the side to move
+    const int player = (_moves - 1) & 1;
+    const Bitboard stones = _stones[player];
+    const Bitboard cell = Bitboard(1) << (_height[_lastColumn] - 1);
+    for (int shift : SHIFTS) {
+        // walk out both ways; the empty spare bit on top of each column stops a line wrapping
+        int count = 1;
+        for (Bitboard b = cell << shift; (b & stones) && count < 4; b <<= shift)
+            count++;
+        for (Bitboard b = cell >> shift; (b & stones) && count < 4; b >>= shift)
+            count++;
+        if (count >= 4)
+            return {player, false};
+    }
+    return {-1, isFull()};
+}
+
+template <int W, int H>
+typename BasicConnect4Board<W, H>::Bitboard BasicConnect4Board<W, H>::mirrorKey() const
+{
+    // each column is its own HEIGHT + 1 bit field of the key, so reflecting swaps whole fields
+    const Bitboard key = this->key();
+    const Bitboard field = (Bitboard(1) << (HEIGHT + 1)) - 1;
+    Bitboard mirrored = 0;
+    for (int col = 0; col < WIDTH; col++) {
+        mirrored |= ((key >> (col * (HEIGHT + 1))) & field) << ((WIDTH - 1 - col) * (HEIGHT + 1));
+    }
+    return mirrored;
+}
+
+template <int W, int H>
+int BasicConnect4Board<W, H>::cellOwner(int column, int row) const
+{
+    const Bitboard bit = Bitboard(1) << (column * (HEIGHT + 1) + row);
+    if (_stones[0] & bit)
+        return 0;
+    if (_stones[1] & bit)
+        return 1;
+    return -1;
+}
+
+template class BasicConnect4Board<7, 6>;
+template class BasicConnect4Board<8, 7>;
+template class BasicConnect4Board<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+template class BasicConnect4Board<9, 7>;
+#endif
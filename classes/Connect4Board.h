@@ -0,0 +1,193 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <string>
+
+// boards that need more than 64 bits (9x7 takes 72) use a 128-bit bitboard,
+// which only GCC and Clang provide
+#if defined(__SIZEOF_INT128__)
+#define CONNECT4_WIDE_BOARDS 1
+#endif
+
+template <bool Wide> struct Connect4Bitboard;
+template <> struct Connect4Bitboard<false> { typedef uint64_t type; };
+#ifdef CONNECT4_WIDE_BOARDS
+template <> struct Connect4Bitboard<true> { typedef unsigned __int128 type; };
+#endif
+
+struct Connect4Outcome {
+    int winner;     // -1 = none, otherwise the winning player number
+    bool draw;
+};
+
+//
+// compact Connect Four position used by the rules and the AI search
+//
+// each player owns a bitboard. a column uses HEIGHT + 1 bits (bit 0 is the
+// bottom row) so the spare bit on top keeps shifted lines from wrapping into
+// the next column. _height[col] is the bit index of the next free cell.
+//
+// the geometry is a template parameter, so every mask below is a compile-time
+// constant and the loops over the four line directions unroll for each size.
+// Connect4Board is the standard 7x6 game; the other sizes are instantiated in
+// Connect4Board.cpp and listed in Connect4Engine.
+//
+template <int W, int H>
+class BasicConnect4Board
+{
+public:
+    static const int WIDTH = W;
+    static const int HEIGHT = H;
+    static const int CELLS = W * H;
+
+    static_assert(W >= 4 && H >= 4, "a board must fit four in a row");
+    static_assert(W * (H + 1) <= 128, "a board must fit 128 bits");
+    typedef typename Connect4Bitboard<(W * (H + 1) > 64)>::type Bitboard;
+    typedef Connect4Outcome Outcome;
+
+    BasicConnect4Board();
+
+    // build a position from the row-major (top row first) Connect4::stateString format.
+    // player 1 moves first, so it must have as many discs as player 2 or one more;
+    // anything else could not arise in a game and is rejected
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+    bool        canPlay(int column) const { return (mask() & topMask(column)) == 0; }
+    void        play(int column)
+    {
+        _stones[_moves & 1] |= Bitboard(1) << _height[column]++;
+        _moves++;
+        _lastColumn = column;
+    }
+    bool        isWinningMove(int column) const { return hasFour(_stones[_moves & 1] | (Bitboard(1) << _height[column])); }
+
+    int         currentPlayer() const { return _moves & 1; }
+    int         moveCount() const { return _moves; }
+    bool        isFull() const { return _moves == CELLS; }
+    bool        hasWon(int playerNumber) const { return hasFour(_stones[playerNumber]); }
+    // full scan of both players' stones
+    Outcome     outcome() const;
+    // only the four lines through the last disc played; no wider scan is needed because
+    // the position before that move was still undecided. falls back to outcome() when the
+    // last move is unknown (a position loaded from a state string).
+    Outcome     lastMoveOutcome() const;
+    // column of the last play(), -1 if unknown
+    int         lastColumn() const { return _lastColumn; }
+
+    // number of discs already in the column
+    int         columnHeight(int column) const { return _height[column] - column * (HEIGHT + 1); }
+    // -1 for an empty cell, otherwise the owning player. row 0 is the bottom row.
+    int         cellOwner(int column, int row) const;
+    Bitboard    stones(int playerNumber) const { return _stones[playerNumber]; }
+    Bitboard    mask() const { return _stones[0] | _stones[1]; }
+    // unique per position: adding the mask to one player's stones never carries out of a column
+    Bitboard    key() const { return _stones[0] + mask(); }
+    // key() of the same position reflected left to right
+    Bitboard    mirrorKey() const;
+    // key() spread over all 64 bits, for hash tables
+    uint64_t    hash() const { return hashKey(key()); }
+    // splitmix64 finalizer of a key (or a mirrorKey())
+    static uint64_t hashKey(Bitboard key)
+    {
+        uint64_t h = (uint64_t)key;
+        if constexpr (sizeof(Bitboard) > sizeof(uint64_t))
+            h ^= (uint64_t)(key >> 64) * UINT64_C(0x9e3779b97f4a7c15);
+        h ^= h >> 30;
+        h *= UINT64_C(0xbf58476d1ce4e5b9);
+        h ^= h >> 27;
+        h *= UINT64_C(0x94d049bb133111eb);
+        h ^= h >> 31;
+        return h;
+    }
+
+    // the cell each non-full column would take next
+    Bitboard    playableCells() const { return (mask() + bottomRow()) & fullBoard(); }
+    // playable cells that neither ignore an immediate threat of the opponent nor let it
+    // win by playing on top; 0 when every move loses at once
+    Bitboard    nonLosingMoves() const
+    {
+        Bitboard playable = playableCells();
+        const Bitboard threats = winningCells(_stones[(_moves & 1) ^ 1], mask());
+        const Bitboard forced = playable & threats;
+        if (forced) {
+            // two immediate threats cannot both be blocked
+            if (forced & (forced - 1))
+                return 0;
+            playable = forced;
+        }
+        // never play directly below an opponent's winning cell
+        return playable & ~(threats >> 1);
+    }
+
+    static bool hasFour(Bitboard stones)
+    {
+        for (int shift : SHIFTS) {
+            const Bitboard pairs = stones & (stones >> shift);
+            if (pairs & (pairs >> (2 * shift)))
+                return true;
+        }
+        return false;
+    }
+    // empty cells (playable or not) where stones would complete four in a row;
+    // inline, since the search and the evaluation call it at every node
+    static Bitboard winningCells(Bitboard stones, Bitboard mask)
+    {
+        // vertical: only three below can complete a column
+        Bitboard cells = (stones << 1) & (stones << 2) & (stones << 3);
+
+        // horizontal and the two diagonals: the empty cell can be any of the four in the line
+        for (int i = 1; i < 4; i++) {
+            const int shift = SHIFTS[i];
+            Bitboard pair = (stones << shift) & (stones << (2 * shift));
+            cells |= pair & (stones << (3 * shift));
+            cells |= pair & (stones >> shift);
+            pair = (stones >> shift) & (stones >> (2 * shift));
+            cells |= pair & (stones << shift);
+            cells |= pair & (stones >> (3 * shift));
+        }
+        return cells & (fullBoard() ^ mask);
+    }
+    static int  popcount(Bitboard b)
+    {
+        if constexpr (sizeof(Bitboard) > sizeof(uint64_t))
+            return std::popcount((uint64_t)b) + std::popcount((uint64_t)(b >> 64));
+        else
+            return std::popcount(b);
+    }
+
+    // vertical, horizontal and the two diagonals, each as a bit distance between neighbours
+    static constexpr int SHIFTS[4] = {1, HEIGHT + 1, HEIGHT, HEIGHT + 2};
+
+    // one bit per column
+    static constexpr Bitboard bottomRow()
+    {
+        Bitboard row = 0;
+        for (int col = 0; col < WIDTH; col++)
+            row |= bottomMask(col);
+        return row;
+    }
+    // every real cell, without the spare bit on top of each column
+    static constexpr Bitboard fullBoard() { return bottomRow() * ((Bitboard(1) << HEIGHT) - 1); }
+    static constexpr Bitboard bottomMask(int column) { return Bitboard(1) << (column * (HEIGHT + 1)); }
+    static constexpr Bitboard topMask(int column) { return Bitboard(1) << (column * (HEIGHT + 1) + HEIGHT - 1); }
+    static constexpr Bitboard columnMask(int column) { return ((Bitboard(1) << HEIGHT) - 1) << (column * (HEIGHT + 1)); }
+    // i-th column in center-out order: 3, 2, 4, 1, 5, 0, 6 on a 7-wide board
+    static constexpr int centerOrder(int i) { return WIDTH / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2; }
+
+private:
+    Bitboard    _stones[2];
+    int         _height[WIDTH];
+    int         _moves;
+    int         _lastColumn;
+};
+
+// the standard game
+typedef BasicConnect4Board<7, 6> Connect4Board;
+
+extern template class BasicConnect4Board<7, 6>;
+extern template class BasicConnect4Board<8, 7>;
+extern template class BasicConnect4Board<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+extern template class BasicConnect4Board<9, 7>;
+#endif
@@ -0,0 +1,142 @@
+#include "Connect4Book.h"
+#include "Connect4Search.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'C', '4', 'B', 'K'};
+const uint32_t VERSION = 1;
+
+struct Header
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t maxPly;
+    uint32_t searchDepth;
+    uint64_t count;
+};
+static_assert(sizeof(Header) == 32, "book header must stay 32 bytes");
+
+// an entry, high to low: key (49 bits) | move (3 bits) | score (12 bits, signed)
+const int KEY_SHIFT = 15;
+const int MOVE_SHIFT = 12;
+const uint64_t SCORE_MASK = 0xfff;
+static_assert(Connect4Board::WIDTH * (Connect4Board::HEIGHT + 1) + KEY_SHIFT <= 64, "key does not fit an entry");
+
+// heuristic scores are far inside 12 bits; wins keep their distance as 2047 - plies to go
+const int SCORE_LIMIT = 2047;
+
+int compressScore(int score)
+{
+    if (Connect4Search::isWinScore(score)) {
+        const int distance = Connect4Search::WIN_SCORE - std::abs(score);
+        return score > 0 ? SCORE_LIMIT - distance : -(SCORE_LIMIT - distance);
+    }
+    return std::max(-(SCORE_LIMIT - Connect4Search::MAX_PLY - 1), std::min(SCORE_LIMIT - Connect4Search::MAX_PLY - 1, score));
+}
+
+int expandScore(int stored)
+{
+    if (std::abs(stored) >= SCORE_LIMIT - Connect4Search::MAX_PLY) {
+        const int distance = SCORE_LIMIT - std::abs(stored);
+        return stored > 0 ? Connect4Search::WIN_SCORE - distance : -(Connect4Search::WIN_SCORE - distance);
+    }
+    return stored;
+}
+
+}
+
+bool Connect4Book::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path))
+        return false;
+
+    Header header;
+    if (_file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.width != (uint32_t)Connect4Board::WIDTH || header.height != (uint32_t)Connect4Board::HEIGHT ||
+        header.count != (_file.size() - sizeof(Header)) / sizeof(uint64_t)) {
+        close();
+        return false;
+    }
+
+    _entries = reinterpret_cast<const uint64_t *>(_file.data() + sizeof(Header));
+    _count = (size_t)header.count;
+    _maxPly = (int)header.maxPly;
+    _depth = (int)header.searchDepth;
+    return true;
+}
+
+void Connect4Book::close()
+{
+    _file.close();
+    _entries = nullptr;
+    _count = 0;
+    _maxPly = 0;
+    _depth = 0;
+}
+
+uint64_t Connect4Book::canonicalKey(const Connect4Board &board, bool &mirrored)
+{
+    const uint64_t key = board.key();
+    const uint64_t mirror = board.mirrorKey();
+    mirrored = mirror < key;
+    return mirrored ? mirror : key;
+}
+
+uint64_t Connect4Book::packEntry(uint64_t key, int move, int score)
+{
+    return (key << KEY_SHIFT) | ((uint64_t)move << MOVE_SHIFT) | ((uint64_t)compressScore(score) & SCORE_MASK);
+}
+
+bool Connect4Book::probe(const Connect4Board &board, Entry &entry) const
+{
+    if (!_entries || board.moveCount() > _maxPly)
+        return false;
+
+    bool mirrored;
+    const uint64_t key = canonicalKey(board, mirrored);
+    const uint64_t lowest = key << KEY_SHIFT;
+    const uint64_t *found = std::lower_bound(_entries, _entries + _count, lowest);
+    if (found == _entries + _count || (*found >> KEY_SHIFT) != key)
+        return false;
+
+    const int move = (int)((*found >> MOVE_SHIFT) & 0x7);
+    // sign-extend the 12-bit score
+    const int stored = (int)(*found & SCORE_MASK);
+    entry.move = mirrored ? Connect4Board::WIDTH - 1 - move : move;
+    entry.score = expandScore(stored >= 2048 ? stored - 4096 : stored);
+    return board.canPlay(entry.move);
+}
+
+bool Connect4Book::write(const std::string &path, std::vector<uint64_t> entries, int maxPly, int searchDepth)
+{
+    std::sort(entries.begin(), entries.end());
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = Connect4Board::WIDTH;
+    header.height = Connect4Board::HEIGHT;
+    header.maxPly = (uint32_t)maxPly;
+    header.searchDepth = (uint32_t)searchDepth;
+    header.count = entries.size();
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !entries.empty())
+        ok = std::fwrite(entries.data(), sizeof(uint64_t), entries.size(), file) == entries.size();
+    return std::fclose(file) == 0 && ok;
+}
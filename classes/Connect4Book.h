@@ -0,0 +1,56 @@
+#pragma once
+#include "Connect4Board.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Connect4 opening book, memory-mapped straight from disk
+//
+// the file is a 32-byte header followed by sorted 64-bit entries, each holding
+// the position key in its high bits and the stored move and score below it, so
+// a probe is a binary search over the mapping with nothing loaded up front.
+// a position and its mirror image share one entry under the smaller of the two
+// keys; probing the mirrored side reflects the stored column back.
+//
+// the file is written little-endian, which every platform the game ships on is.
+// books exist for the standard 7x6 board only: the key of a larger board leaves
+// no room for the move and score in a 64-bit entry.
+//
+class Connect4Book
+{
+public:
+    struct Entry {
+        int move;       // column for the side to move
+        int score;      // Connect4Search score from the side to move's point of view
+    };
+
+    Connect4Book() : _entries(nullptr), _count(0), _maxPly(0), _depth(0) {}
+
+    // map a book file; false (and an empty book) if it is missing or not a book for this board size
+    bool        open(const std::string &path);
+    void        close();
+
+    bool        isOpen() const { return _entries != nullptr; }
+    size_t      size() const { return _count; }
+    // deepest ply the generator filled, and the search depth it used
+    int         maxPly() const { return _maxPly; }
+    int         searchDepth() const { return _depth; }
+
+    bool        probe(const Connect4Board &board, Entry &entry) const;
+
+    // position key with mirror symmetry folded; mirrored says the stored move must be reflected
+    static uint64_t canonicalKey(const Connect4Board &board, bool &mirrored);
+    // one entry for canonicalKey(); move is in the canonical orientation
+    static uint64_t packEntry(uint64_t key, int move, int score);
+    // sort the entries and write a book file
+    static bool write(const std::string &path, std::vector<uint64_t> entries, int maxPly, int searchDepth);
+
+private:
+    MappedFile  _file;
+    const uint64_t *_entries;
+    size_t      _count;
+    int         _maxPly;
+    int         _depth;
+};
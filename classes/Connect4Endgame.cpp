@@ -0,0 +1,203 @@
+#include "Connect4Endgame.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'C', '4', 'E', 'G'};
+const uint32_t VERSION = 2;
+
+struct Header
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t minEmpty;
+    uint32_t maxEmpty;
+    uint32_t bucketBits;
+    uint32_t entryBits;
+    uint64_t count;
+    uint8_t  padding[24];
+};
+// the header fills one cache line, so the index that follows starts on one
+static_assert(sizeof(Header) == 64, "endgame header must stay 64 bytes");
+
+const int KEY_BITS = Connect4Board::WIDTH * (Connect4Board::HEIGHT + 1);
+const uint64_t KEY_MASK = (uint64_t(1) << KEY_BITS) - 1;
+// any odd multiplier is a bijection on the key bits and carries every bit into the top ones
+const uint64_t KEY_MIX = 0x9e3779b97f4a7c15ull;
+// the writer splits the entries into buckets of at most this many on average
+const uint64_t BUCKET_ENTRIES = 8;
+
+// an entry, high to low: the mixed key below the bucket bits | score + 8 (4 bits)
+const int SCORE_BITS = 4;
+const uint64_t SCORE_MASK = 0xf;
+const int SCORE_OFFSET = 8;
+static_assert(KEY_BITS + SCORE_BITS + 7 <= 64, "an entry must fit one unaligned 64-bit read");
+static_assert((Connect4Endgame::MAX_EMPTY + 1) / 2 + SCORE_OFFSET <= (int)SCORE_MASK, "scores do not fit an entry");
+
+uint64_t mixKey(uint64_t key)
+{
+    return (key * KEY_MIX) & KEY_MASK;
+}
+
+// bytes of packed entries, plus slack so every entry can be read with one 64-bit load
+uint64_t entryBytes(uint64_t count, int entryBits)
+{
+    return (count * entryBits + 7) / 8 + sizeof(uint64_t);
+}
+
+}
+
+bool Connect4Endgame::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path))
+        return false;
+
+    Header header;
+    if (_file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.width != (uint32_t)Connect4Board::WIDTH || header.height != (uint32_t)Connect4Board::HEIGHT ||
+        header.minEmpty > header.maxEmpty || header.maxEmpty > (uint32_t)MAX_EMPTY ||
+        header.bucketBits > 32 || header.entryBits != KEY_BITS - header.bucketBits + SCORE_BITS || header.count > 0xffffffffu) {
+        close();
+        return false;
+    }
+    const uint64_t indexBytes = ((uint64_t(1) << header.bucketBits) + 1) * sizeof(uint32_t);
+    if (_file.size() != sizeof(Header) + indexBytes + entryBytes(header.count, (int)header.entryBits)) {
+        close();
+        return false;
+    }
+
+    _index = reinterpret_cast<const uint32_t *>(_file.data() + sizeof(Header));
+    _entries = reinterpret_cast<const uint8_t *>(_file.data() + sizeof(Header) + indexBytes);
+    _bucketBits = (int)header.bucketBits;
+    _entryBits = (int)header.entryBits;
+    _count = (size_t)header.count;
+    _minEmpty = (int)header.minEmpty;
+    _maxEmpty = (int)header.maxEmpty;
+    if (_index[uint64_t(1) << _bucketBits] != _count) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void Connect4Endgame::close()
+{
+    _file.close();
+    _index = nullptr;
+    _entries = nullptr;
+    _bucketBits = 0;
+    _entryBits = 0;
+    _count = 0;
+    _minEmpty = 0;
+    _maxEmpty = -1;
+}
+
+uint64_t Connect4Endgame::canonicalKey(const Connect4Board &board)
+{
+    const uint64_t key = board.key();
+    const uint64_t mirror = board.mirrorKey();
+    return mirror < key ? mirror : key;
+}
+
+uint64_t Connect4Endgame::packEntry(uint64_t key, int score)
+{
+    return (key << SCORE_BITS) | (uint64_t)(score + SCORE_OFFSET);
+}
+
+uint64_t Connect4Endgame::entry(uint64_t i) const
+{
+    // entries are packed little-end first, like the words of the rest of the file
+    const uint64_t bit = i * _entryBits;
+    uint64_t word;
+    std::memcpy(&word, _entries + bit / 8, sizeof(word));
+    return (word >> (bit % 8)) & ((uint64_t(1) << _entryBits) - 1);
+}
+
+bool Connect4Endgame::probe(const Connect4Board &board, int &score) const
+{
+    if (!_index || !covers(board))
+        return false;
+
+    const uint64_t mixed = mixKey(canonicalKey(board));
+    const int restBits = KEY_BITS - _bucketBits;
+    const uint64_t bucket = mixed >> restBits;
+    const uint64_t rest = mixed & ((uint64_t(1) << restBits) - 1);
+    const uint64_t end = std::min<uint64_t>(_index[bucket + 1], _count);
+    // a bucket is sorted, so the scan stops at the first larger key
+    for (uint64_t i = _index[bucket]; i < end; i++) {
+        const uint64_t found = entry(i);
+        if ((found >> SCORE_BITS) < rest)
+            continue;
+        if ((found >> SCORE_BITS) > rest)
+            return false;
+        score = (int)(found & SCORE_MASK) - SCORE_OFFSET;
+        return true;
+    }
+    return false;
+}
+
+bool Connect4Endgame::write(const std::string &path, const std::vector<uint64_t> &entries, int minEmpty, int maxEmpty)
+{
+    if (minEmpty < 0 || minEmpty > maxEmpty || maxEmpty > MAX_EMPTY || entries.size() > 0xffffffffu)
+        return false;
+
+    // the mixed key replaces the key, so the sort order is the probe order
+    std::vector<uint64_t> sorted;
+    sorted.reserve(entries.size());
+    for (uint64_t packed : entries)
+        sorted.push_back((mixKey(packed >> SCORE_BITS) << SCORE_BITS) | (packed & SCORE_MASK));
+    std::sort(sorted.begin(), sorted.end());
+
+    int bucketBits = 0;
+    while (bucketBits < KEY_BITS && (sorted.size() >> bucketBits) > BUCKET_ENTRIES)
+        bucketBits++;
+    const int restBits = KEY_BITS - bucketBits;
+    const int entryBits = restBits + SCORE_BITS;
+
+    std::vector<uint32_t> index((uint64_t(1) << bucketBits) + 1, 0);
+    for (uint64_t packed : sorted)
+        index[(packed >> SCORE_BITS >> restBits) + 1]++;
+    for (size_t i = 1; i < index.size(); i++)
+        index[i] += index[i - 1];
+
+    std::vector<uint8_t> bytes(entryBytes(sorted.size(), entryBits), 0);
+    const uint64_t entryMask = (uint64_t(1) << entryBits) - 1;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const uint64_t bit = i * entryBits;
+        const uint64_t value = (sorted[i] & entryMask) << (bit % 8);
+        for (int k = 0; k < 8; k++)
+            bytes[bit / 8 + k] |= (uint8_t)(value >> (8 * k));
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = Connect4Board::WIDTH;
+    header.height = Connect4Board::HEIGHT;
+    header.minEmpty = (uint32_t)minEmpty;
+    header.maxEmpty = (uint32_t)maxEmpty;
+    header.bucketBits = (uint32_t)bucketBits;
+    header.entryBits = (uint32_t)entryBits;
+    header.count = sorted.size();
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok)
+        ok = std::fwrite(index.data(), sizeof(uint32_t), index.size(), file) == index.size();
+    if (ok)
+        ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Connect4Board.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Connect4 endgame database: exact results of positions with few empty cells,
+// memory-mapped straight from disk
+//
+// the file is a 64-byte header, a bucket index and the entries, sorted by a
+// mixed form of the position key (a bijection, so no two positions collide).
+// the top bits of the mixed key pick a bucket and the index says where its
+// entries start. an entry holds only the remaining key bits and a 4-bit score,
+// bit-packed, so a position costs 4 to 6 bytes and still matches exactly. a
+// bucket holds 4 to 8 entries on average, so a probe reads one index word and
+// one short run of entries. a position and its mirror image share one entry.
+//
+// the database does not hold every position in its range: with 12 to 14 empty
+// cells alone there are hundreds of billions. it holds every position reachable
+// from the endgames of the sample games c4endgame plays (see the tool), with
+// between minEmpty() and maxEmpty() empty cells, so a miss says nothing about
+// a position and the search carries on as usual. maxEmpty() is at most
+// MAX_EMPTY, which keeps every score within the entry. closer to the end a
+// position is cheaper to search than to look up, so the tables leave those out
+// and never probe them. positions where the side to move can win at once are
+// not stored either: the search and the solver find those before they probe.
+// like the opening book, the database exists for the standard 7x6 board only.
+//
+class Connect4Endgame
+{
+public:
+    // the most empty cells a stored position may have; scores then stay within -7..7
+    static const int MAX_EMPTY = 14;
+
+    Connect4Endgame() : _index(nullptr), _entries(nullptr), _bucketBits(0), _entryBits(0), _count(0), _minEmpty(0), _maxEmpty(-1) {}
+
+    // map a database file; false (and an empty database) if it is missing or not for this board size
+    bool        open(const std::string &path);
+    void        close();
+
+    bool        isOpen() const { return _index != nullptr; }
+    size_t      size() const { return _count; }
+    // the range of empty cells the stored positions have
+    int         minEmpty() const { return _minEmpty; }
+    int         maxEmpty() const { return _maxEmpty; }
+    // cheap first test for the search loops, before the position is hashed
+    bool        covers(const Connect4Board &board) const
+    {
+        const int empty = Connect4Board::CELLS - board.moveCount();
+        return empty <= _maxEmpty && empty >= _minEmpty;
+    }
+
+    // exact score (Connect4Solver scale) if the position is stored
+    bool        probe(const Connect4Board &board, int &score) const;
+
+    // key with mirror symmetry folded
+    static uint64_t canonicalKey(const Connect4Board &board);
+    static uint64_t packEntry(uint64_t key, int score);
+    // sort and pack the entries (from packEntry) and write a database file
+    static bool write(const std::string &path, const std::vector<uint64_t> &entries, int minEmpty, int maxEmpty);
+
+private:
+    // the entry at a position in the sorted order: remaining key bits above the score
+    uint64_t    entry(uint64_t i) const;
+
+    MappedFile  _file;
+    const uint32_t *_index;     // first entry of each bucket, and the entry count after the last
+    const uint8_t *_entries;
+    int         _bucketBits;
+    int         _entryBits;
+    size_t      _count;
+    int         _minEmpty;
+    int         _maxEmpty;
+};
@@ -0,0 +1,201 @@
+#include "Connect4Engine.h"
+#include "Connect4Solver.h"
+
+namespace {
+// with more empty cells than this an exact solve can take far too long, so the
+// search plays instead. the cost grows with the board, so each size has its own
+// limit: on the standard board the solver takes over after the first 8 plies. a
+// size without a measured limit leaves every position to the search.
+template <int W, int H>
+const int SOLVER_MAX_EMPTY = 0;
+template <>
+const int SOLVER_MAX_EMPTY<7, 6> = 34;
+template <>
+const int SOLVER_MAX_EMPTY<6, 5> = 28;
+template <>
+const int SOLVER_MAX_EMPTY<8, 7> = 30;
+
+template <int W, int H>
+class BasicConnect4Engine : public Connect4Engine
+{
+public:
+    typedef BasicConnect4Board<W, H> Board;
+
+    int width() const override { return W; }
+    int height() const override { return H; }
+
+    void newGame() override
+    {
+        _board = Board();
+        _search.newGame();
+    }
+    bool canPlay(int column) const override { return _board.canPlay(column); }
+    void play(int column) override { _board.play(column); }
+    int columnHeight(int column) const override { return _board.columnHeight(column); }
+    int cellOwner(int column, int row) const override { return _board.cellOwner(column, row); }
+    int moveCount() const override { return _board.moveCount(); }
+    Connect4Outcome lastMoveOutcome() const override { return _board.lastMoveOutcome(); }
+    std::string stateString() const override { return _board.stateString(); }
+    bool setStateString(const std::string &s) override { return _board.setStateString(s); }
+
+    bool bookMove(const Connect4Book &book, int &column) const override
+    {
+        if constexpr (W == Connect4Board::WIDTH && H == Connect4Board::HEIGHT) {
+            Connect4Book::Entry entry;
+            if (book.probe(_board, entry)) {
+                column = entry.move;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void setEndgame(const Connect4Endgame *endgame) override { _search.setEndgame(endgame); }
+
+    MoveJob moveJob(const Connect4SearchLimits &limits, bool perfectPlay, StatsSink onStats) override
+    {
+        const Board board = _board;
+        if (perfectPlay && Board::CELLS - board.moveCount() <= SOLVER_MAX_EMPTY<W, H>) {
+            if (!_solver) {
+                _solver = std::make_unique<BasicConnect4Solver<W, H>>();
+            }
+            return [this, board, onStats](const std::atomic<bool> &cancel) {
+                const Connect4SolveResult result = _solver->bestMove(board, &cancel);
+                if (onStats) {
+                    // the solver reads to the end of the game and keeps no per-ply counters
+                    SearchStats stats;
+                    stats.nodes = result.nodes;
+                    stats.depth = Board::CELLS - board.moveCount();
+                    stats.timeMs = result.timeMs;
+                    onStats(stats);
+                }
+                return result.move;
+            };
+        }
+        return [this, board, limits, onStats](const std::atomic<bool> &cancel) {
+            const Connect4SearchResult result = _search.search(board, limits, &cancel);
+            if (onStats) {
+                onStats(result.stats);
+            }
+            return result.move;
+        };
+    }
+
+    MoveJob ponderJob(const Connect4SearchLimits &limits, bool perfectPlay) override
+    {
+        _pondered.clear();
+        // the solver answers the replies exactly and without the search's table
+        if (perfectPlay && Board::CELLS - _board.moveCount() - 1 <= SOLVER_MAX_EMPTY<W, H>)
+            return nullptr;
+        for (int column = 0; column < W; column++) {
+            // a winning reply ends the game, so there is nothing to answer
+            if (!_board.canPlay(column) || _board.isWinningMove(column))
+                continue;
+            Pondered reply;
+            reply.board = _board;
+            reply.board.play(column);
+            _pondered.push_back(reply);
+        }
+        if (_pondered.empty())
+            return nullptr;
+
+        const int threads = limits.threads;
+        return [this, threads](const std::atomic<bool> &cancel) {
+            // one generation for the whole job: a new one per reply search would age the
+            // entries of the other replies, and soon wrap around onto them
+            _search.table().newSearch();
+            // one ply deeper on every reply per round, so whichever the opponent picks has been
+            // searched about as far as the others. each round runs only its new iteration and
+            // carries on from the reply's last score, so the rounds add up to one deepening
+            // search per reply rather than restarting it from depth 1 every time.
+            Connect4SearchLimits round;
+            round.threads = threads;
+            round.newGeneration = false;
+            for (bool deeper = true; deeper && !cancel;) {
+                deeper = false;
+                for (Pondered &reply : _pondered) {
+                    if (cancel)
+                        break;
+                    if (reply.finished)
+                        continue;
+                    round.startDepth = reply.depth + 1;
+                    round.maxDepth = reply.depth + 1;
+                    round.startScore = reply.score;
+                    const Connect4SearchResult result = _search.search(reply.board, round, &cancel);
+                    reply.timeMs += result.stats.timeMs;
+                    if (result.move < 0) {
+                        // the reply fills the board
+                        reply.finished = true;
+                    } else if (result.depth > reply.depth) {
+                        reply.move = result.move;
+                        reply.score = result.score;
+                        reply.depth = result.depth;
+                        reply.stats = result.stats;
+                        // a proven result or a search to the last cell cannot change with depth
+                        reply.finished = BasicConnect4Search<W, H>::isWinScore(result.score) ||
+                                         reply.depth >= Board::CELLS - reply.board.moveCount();
+                    }
+                    deeper = deeper || !reply.finished;
+                }
+            }
+            return -1;
+        };
+    }
+
+    bool ponderedMove(int minTimeMs, int &column, SearchStats &stats) const override
+    {
+        for (const Pondered &reply : _pondered) {
+            if (reply.board.key() != _board.key())
+                continue;
+            if (reply.move < 0 || (reply.timeMs < minTimeMs && !reply.finished))
+                return false;
+            column = reply.move;
+            stats = reply.stats;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // one opponent reply searched by the ponder job
+    struct Pondered {
+        Board   board;              // position after the reply
+        int     move = -1;
+        int     score = 0;          // of the deepest round, to centre the next one's window
+        int     depth = 0;
+        double  timeMs = 0.0;       // summed over the rounds
+        bool    finished = false;
+        SearchStats stats;          // of the deepest round
+    };
+
+    Board       _board;
+    BasicConnect4Search<W, H> _search;
+    std::unique_ptr<BasicConnect4Solver<W, H>> _solver;    // created the first time perfect play is asked for
+    std::vector<Pondered> _pondered;    // written only by the ponder job, read after it stops
+};
+
+template <int W, int H>
+std::unique_ptr<Connect4Engine> createEngine()
+{
+    return std::make_unique<BasicConnect4Engine<W, H>>();
+}
+
+const Connect4Engine::Variant VARIANTS[] = {
+    {"7x6 (standard)", 7, 6, &createEngine<7, 6>},
+    {"8x7", 8, 7, &createEngine<8, 7>},
+    {"6x5", 6, 5, &createEngine<6, 5>},
+#ifdef CONNECT4_WIDE_BOARDS
+    {"9x7", 9, 7, &createEngine<9, 7>},
+#endif
+};
+}
+
+int Connect4Engine::variantCount()
+{
+    return (int)(sizeof(VARIANTS) / sizeof(VARIANTS[0]));
+}
+
+const Connect4Engine::Variant &Connect4Engine::variant(int index)
+{
+    return VARIANTS[index >= 0 && index < variantCount() ? index : 0];
+}
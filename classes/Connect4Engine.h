@@ -0,0 +1,69 @@
+#pragma once
+#include "Connect4Board.h"
+#include "Connect4Book.h"
+#include "Connect4Endgame.h"
+#include "Connect4Search.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+//
+// one Connect4 board size behind a virtual interface
+//
+// the board, search and solver are templates on the board size, so each size
+// gets its own constant-folded code. the game picks a size at runtime from
+// Connect4Engine::variant() and talks to it through this class; only the
+// calls made once per move are virtual, the search itself never is.
+//
+class Connect4Engine
+{
+public:
+    // same signature as Game::AISearchJob
+    typedef std::function<int(const std::atomic<bool> &cancel)> MoveJob;
+    // receives the cost of the job's search on the job's thread
+    typedef std::function<void(const SearchStats &stats)> StatsSink;
+
+    virtual ~Connect4Engine() {}
+
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+
+    // empty board; the search forgets the previous game
+    virtual void        newGame() = 0;
+    virtual bool        canPlay(int column) const = 0;
+    virtual void        play(int column) = 0;
+    virtual int         columnHeight(int column) const = 0;
+    // -1 for an empty cell, otherwise the owning player. row 0 is the bottom row.
+    virtual int         cellOwner(int column, int row) const = 0;
+    virtual int         moveCount() const = 0;
+    virtual Connect4Outcome lastMoveOutcome() const = 0;
+    virtual std::string stateString() const = 0;
+    virtual bool        setStateString(const std::string &s) = 0;
+
+    // the book move for the current position, if the book covers it (standard board only)
+    virtual bool        bookMove(const Connect4Book &book, int &column) const = 0;
+    // endgame results for the search to read (standard board only); must outlive the engine
+    virtual void        setEndgame(const Connect4Endgame *endgame) = 0;
+    // a job that finds a move for a copy of the current position, for Game::startAISearch.
+    // perfect play uses the exact solver once few enough cells are left for it to be quick.
+    virtual MoveJob     moveJob(const Connect4SearchLimits &limits, bool perfectPlay, StatsSink onStats = nullptr) = 0;
+    // a job that searches every reply the opponent could make to the current position, all
+    // deepened together until it is cancelled, for Game::startPonder. the table entries stay
+    // in the search and the best answer to each reply is kept until the next ponder job.
+    // empty when the solver would answer those positions instead.
+    virtual MoveJob     ponderJob(const Connect4SearchLimits &limits, bool perfectPlay) = 0;
+    // the pondered answer to the current position, if its searches took at least minTimeMs.
+    // only valid once the ponder job has stopped.
+    virtual bool        ponderedMove(int minTimeMs, int &column, SearchStats &stats) const = 0;
+
+    struct Variant {
+        const char *name;
+        int width;
+        int height;
+        std::unique_ptr<Connect4Engine> (*create)();
+    };
+    // the board sizes built into the game; variant 0 is the standard 7x6 board
+    static int  variantCount();
+    static const Variant &variant(int index);
+};
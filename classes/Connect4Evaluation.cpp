@@ -0,0 +1,131 @@
+#include "Connect4Evaluation.h"
+#include "Connect4Search.h"
+
+namespace {
+// the masks for one board size, all built at compile time
+template <int W, int H>
+struct EvaluationMasks
+{
+    typedef BasicConnect4Board<W, H> Board;
+    typedef typename Board::Bitboard Bitboard;
+
+    // bit p is set when the window p, p+s, p+2s, p+3s lies entirely on the board
+    static constexpr Bitboard windowStarts(int shift)
+    {
+        const Bitboard cells = Board::fullBoard();
+        return cells & (cells >> shift) & (cells >> (2 * shift)) & (cells >> (3 * shift));
+    }
+
+    static constexpr Bitboard rowsFrom(int first)
+    {
+        Bitboard rows = 0;
+        for (int row = first; row < H; row += 2)
+            rows |= Board::bottomRow() << row;
+        return rows;
+    }
+
+    static constexpr Bitboard STARTS[4] = {windowStarts(Board::SHIFTS[0]), windowStarts(Board::SHIFTS[1]),
+                                           windowStarts(Board::SHIFTS[2]), windowStarts(Board::SHIFTS[3])};
+    static constexpr Bitboard PARITY_ROWS[2] = {rowsFrom(0), rowsFrom(1)};
+    static constexpr Bitboard CENTER = Board::columnMask(W / 2);
+};
+
+// per window start: the window holds exactly two / exactly three of the discs in its four shifted copies
+template <typename Bitboard>
+void classify(Bitboard a, Bitboard b, Bitboard c, Bitboard d, Bitboard &two, Bitboard &three)
+{
+    // two half adders, then the carries; when both pairs carry the sums are 0, so four is carry1 & carry2
+    const Bitboard sum1 = a ^ b, carry1 = a & b;
+    const Bitboard sum2 = c ^ d, carry2 = c & d;
+    const Bitboard ones = sum1 ^ sum2;
+    const Bitboard twosBit = carry1 ^ carry2 ^ (sum1 & sum2);
+    const Bitboard fours = carry1 & carry2;
+    two = twosBit & ~ones & ~fours;
+    three = twosBit & ones & ~fours;
+}
+
+// open twos and threes of both players, by window start, in one pass over the four directions
+template <int W, int H>
+void countWindows(typename BasicConnect4Board<W, H>::Bitboard own, typename BasicConnect4Board<W, H>::Bitboard other,
+                  int ownCounts[2], int otherCounts[2])
+{
+    typedef BasicConnect4Board<W, H> Board;
+    typedef typename Board::Bitboard Bitboard;
+    ownCounts[0] = ownCounts[1] = otherCounts[0] = otherCounts[1] = 0;
+    for (int i = 0; i < 4; i++) {
+        const int s = Board::SHIFTS[i];
+        const Bitboard o1 = own >> s, o2 = own >> (2 * s), o3 = own >> (3 * s);
+        const Bitboard t1 = other >> s, t2 = other >> (2 * s), t3 = other >> (3 * s);
+        const Bitboard ownOpen = EvaluationMasks<W, H>::STARTS[i] & ~(other | t1 | t2 | t3);
+        const Bitboard otherOpen = EvaluationMasks<W, H>::STARTS[i] & ~(own | o1 | o2 | o3);
+
+        Bitboard two, three;
+        classify(own, o1, o2, o3, two, three);
+        ownCounts[0] += Board::popcount(ownOpen & two);
+        ownCounts[1] += Board::popcount(ownOpen & three);
+        classify(other, t1, t2, t3, two, three);
+        otherCounts[0] += Board::popcount(otherOpen & two);
+        otherCounts[1] += Board::popcount(otherOpen & three);
+    }
+}
+}
+
+template <int W, int H>
+typename BasicConnect4Board<W, H>::Bitboard BasicConnect4Evaluation<W, H>::parityRows(int player)
+{
+    return EvaluationMasks<W, H>::PARITY_ROWS[player];
+}
+
+template <int W, int H>
+typename BasicConnect4Evaluation<W, H>::Terms BasicConnect4Evaluation<W, H>::terms(const Board &board, int player)
+{
+    typedef EvaluationMasks<W, H> Masks;
+    const auto own = board.stones(player);
+    const auto other = board.stones(1 - player);
+    const auto threats = Board::winningCells(own, board.mask());
+
+    int ownCounts[2], otherCounts[2];
+    countWindows<W, H>(own, other, ownCounts, otherCounts);
+
+    Terms terms;
+    terms.center = Board::popcount(own & Masks::CENTER);
+    terms.openTwos = ownCounts[0];
+    terms.openThrees = ownCounts[1];
+    terms.threats = Board::popcount(threats);
+    terms.parityThreats = Board::popcount(threats & Masks::PARITY_ROWS[player]);
+    return terms;
+}
+
+template <int W, int H>
+int BasicConnect4Evaluation<W, H>::evaluate(const Board &board)
+{
+    // the same sum as terms() for both players, without computing anything twice
+    typedef EvaluationMasks<W, H> Masks;
+    const int player = board.currentPlayer();
+    const auto own = board.stones(player);
+    const auto other = board.stones(1 - player);
+    const auto otherThreats = Board::winningCells(other, board.mask());
+
+    // two threats the opponent can fill next move can't both be blocked
+    const auto playableThreats = otherThreats & board.playableCells();
+    if (playableThreats & (playableThreats - 1))
+        return -(BasicConnect4Search<W, H>::WIN_SCORE - (board.moveCount() + 2));
+
+    const auto ownThreats = Board::winningCells(own, board.mask());
+    int ownCounts[2], otherCounts[2];
+    countWindows<W, H>(own, other, ownCounts, otherCounts);
+
+    return CENTER_WEIGHT * (Board::popcount(own & Masks::CENTER) - Board::popcount(other & Masks::CENTER)) +
+           OPEN_TWO_WEIGHT * (ownCounts[0] - otherCounts[0]) +
+           OPEN_THREE_WEIGHT * (ownCounts[1] - otherCounts[1]) +
+           THREAT_WEIGHT * (Board::popcount(ownThreats) - Board::popcount(otherThreats)) +
+           PARITY_THREAT_WEIGHT * (Board::popcount(ownThreats & Masks::PARITY_ROWS[player]) -
+                                   Board::popcount(otherThreats & Masks::PARITY_ROWS[1 - player]));
+}
+
+template class BasicConnect4Evaluation<7, 6>;
+template class BasicConnect4Evaluation<8, 7>;
+template class BasicConnect4Evaluation<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+template class BasicConnect4Evaluation<9, 7>;
+#endif
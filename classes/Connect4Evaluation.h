@@ -0,0 +1,57 @@
+#pragma once
+#include "Connect4Board.h"
+
+//
+// static evaluation of a Connect4 position for the side to move
+//
+// everything is computed on the bitboards: the four-cell windows (69 on the
+// standard board) are counted per direction with bit-sliced adders over shifted
+// copies of the stones, and threats (empty cells that would complete four) come
+// from winningCells. the terms, each as the side to move's count minus the opponent's:
+//
+//  - discs in the center column
+//  - open twos and threes: windows holding two or three of a player's discs and
+//    none of the opponent's
+//  - threats, with extra weight on the rows that win the zugzwang fight at the end:
+//    odd rows (1, 3, 5 from the bottom) for the first player, even rows for the second
+//
+// an opponent with two playable threats the side to move cannot win first is an
+// exact loss and scored as one.
+//
+template <int W, int H>
+class BasicConnect4Evaluation
+{
+public:
+    typedef BasicConnect4Board<W, H> Board;
+
+    static const int CENTER_WEIGHT = 3;
+    static const int OPEN_TWO_WEIGHT = 2;
+    static const int OPEN_THREE_WEIGHT = 4;
+    static const int THREAT_WEIGHT = 8;
+    static const int PARITY_THREAT_WEIGHT = 8;
+
+    struct Terms {
+        int center;
+        int openTwos;
+        int openThrees;
+        int threats;
+        int parityThreats;
+    };
+
+    // the side to move has no immediate win (the search returns before evaluating those)
+    static int  evaluate(const Board &board);
+    // one player's raw counts, for tuning and the tools
+    static Terms terms(const Board &board, int player);
+
+    // rows that are good for a player's threats: 0-based rows 0, 2, 4 for player 0
+    static typename Board::Bitboard parityRows(int player);
+};
+
+typedef BasicConnect4Evaluation<7, 6> Connect4Evaluation;
+
+extern template class BasicConnect4Evaluation<7, 6>;
+extern template class BasicConnect4Evaluation<8, 7>;
+extern template class BasicConnect4Evaluation<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+extern template class BasicConnect4Evaluation<9, 7>;
+#endif
@@ -0,0 +1,434 @@
+#include "Connect4Search.h"
+#include "Connect4Evaluation.h"
+#include "Connect4Solver.h"
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+
+namespace {
+// how often (in nodes) the main thread looks at the clock and the cancel flag
+const uint64_t STOP_CHECK_INTERVAL = 1024;
+
+// sort keys for the dynamic ordering; history scores are kept below the killer bonus
+const int PV_BONUS = 1 << 24;
+const int TABLE_MOVE_BONUS = 1 << 23;
+const int KILLER_BONUS = 1 << 22;
+const int HISTORY_LIMIT = 1 << 20;
+
+// killers and history are keyed by the cell the disc lands in, not just the column,
+// since the same column means a different square in sibling positions
+template <int W, int H>
+int dropCell(const BasicConnect4Board<W, H> &board, int column)
+{
+    return column * (H + 1) + board.columnHeight(column);
+}
+}
+
+// per-thread search state
+template <int W, int H>
+struct BasicConnect4Search<W, H>::Worker
+{
+    static const int CELL_COUNT = W * (H + 1);
+
+    int         id = 0;
+    uint64_t    nodes = 0;
+    uint64_t    tableProbes = 0;
+    uint64_t    tableHits = 0;
+    uint64_t    pvsResearches = 0;
+    uint64_t    aspirationFailLows = 0;
+    uint64_t    aspirationFailHighs = 0;
+    uint64_t    endgameHits = 0;
+
+    // triangular principal-variation table for the running iteration and the
+    // line from the previous one that is searched first
+    int         pv[MAX_PLY][MAX_PLY];
+    int         pvLength[MAX_PLY];
+    std::vector<int> previousPV;
+
+    int         killers[MAX_PLY][2];
+    int         history[2][CELL_COUNT];
+    PlyStats    plies[MAX_PLY];
+};
+
+template <int W, int H>
+BasicConnect4Search<W, H>::BasicConnect4Search(size_t tableMegabytes)
+    : _table(tableMegabytes), _cancel(nullptr), _stop(false), _hasDeadline(false), _endgame(nullptr)
+{
+}
+
+template <int W, int H>
+BasicConnect4Search<W, H>::~BasicConnect4Search()
+{
+}
+
+template <int W, int H>
+void BasicConnect4Search<W, H>::newGame()
+{
+    _table.clear();
+}
+
+template <int W, int H>
+int BasicConnect4Search<W, H>::findBestMove(const Board &board, int depth, const std::atomic<bool> *cancel)
+{
+    Connect4SearchLimits limits;
+    limits.maxDepth = depth;
+    return search(board, limits, cancel).move;
+}
+
+template <int W, int H>
+Connect4SearchResult BasicConnect4Search<W, H>::search(const Board &board, const Connect4SearchLimits &limits, const std::atomic<bool> *cancel)
+{
+    const auto start = std::chrono::steady_clock::now();
+    Connect4SearchResult result;
+    _cancel = cancel;
+    _hasDeadline = limits.timeBudgetMs > 0;
+    _deadline = start + std::chrono::milliseconds(limits.timeBudgetMs);
+    _stop = false;
+    if (limits.newGeneration) {
+        _table.newSearch();
+    }
+
+    // always have something legal to play, even if the first iteration is cut short
+    for (int col = 0; col < W && result.move < 0; col++) {
+        if (board.canPlay(col)) {
+            result.move = col;
+        }
+    }
+    if (result.move < 0) {
+        return result;
+    }
+
+    int threads = limits.threads > 0 ? limits.threads : (int)std::thread::hardware_concurrency();
+    threads = std::max(threads, 1);
+    while ((int)_workers.size() < threads) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threads; i++) {
+        Worker &worker = *_workers[i];
+        worker.id = i;
+        worker.nodes = 0;
+        worker.tableProbes = 0;
+        worker.tableHits = 0;
+        worker.pvsResearches = 0;
+        worker.aspirationFailLows = 0;
+        worker.aspirationFailHighs = 0;
+        worker.endgameHits = 0;
+        worker.previousPV.clear();
+        std::fill(&worker.killers[0][0], &worker.killers[0][0] + MAX_PLY * 2, -1);
+        std::fill(worker.plies, worker.plies + MAX_PLY, PlyStats());
+        // keep some history from the last move but let the new position reshape it
+        for (int player = 0; player < 2; player++) {
+            for (int cell = 0; cell < Worker::CELL_COUNT; cell++) {
+                worker.history[player][cell] /= 2;
+            }
+        }
+    }
+
+    const int remaining = Board::CELLS - board.moveCount();
+    const int maxDepth = limits.maxDepth > 0 ? std::min(limits.maxDepth, remaining) : remaining;
+    const int startDepth = std::clamp(limits.startDepth, 1, maxDepth);
+    const int startScore = limits.startScore;
+
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; i++) {
+        helpers.emplace_back([this, i, &board, startDepth, maxDepth, startScore]() {
+            iterate(*_workers[i], board, startDepth, maxDepth, startScore, nullptr);
+        });
+    }
+    iterate(*_workers[0], board, startDepth, maxDepth, startScore, &result);
+    _stop = true;
+    for (std::thread &helper : helpers) {
+        helper.join();
+    }
+
+    SearchStats &stats = result.stats;
+    stats.threads = threads;
+    stats.depth = result.depth;
+    stats.plies.assign(MAX_PLY, PlyStats());
+    for (int i = 0; i < threads; i++) {
+        const Worker &worker = *_workers[i];
+        stats.nodes += worker.nodes;
+        stats.tableProbes += worker.tableProbes;
+        stats.tableHits += worker.tableHits;
+        stats.pvsResearches += worker.pvsResearches;
+        stats.aspirationFailLows += worker.aspirationFailLows;
+        stats.aspirationFailHighs += worker.aspirationFailHighs;
+        stats.endgameHits += worker.endgameHits;
+        for (int ply = 0; ply < MAX_PLY; ply++) {
+            stats.plies[ply].nodes += worker.plies[ply].nodes;
+            stats.plies[ply].cutoffs += worker.plies[ply].cutoffs;
+            stats.plies[ply].firstMoveCutoffs += worker.plies[ply].firstMoveCutoffs;
+        }
+    }
+    while (!stats.plies.empty() && stats.plies.back().nodes == 0) {
+        stats.plies.pop_back();
+    }
+    for (const PlyStats &ply : stats.plies) {
+        stats.cutoffs += ply.cutoffs;
+        stats.firstMoveCutoffs += ply.firstMoveCutoffs;
+    }
+    _table.recordProbes(stats.tableProbes, stats.tableHits);
+    result.stats.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+template <int W, int H>
+void BasicConnect4Search<W, H>::iterate(Worker &worker, const Board &board, int startDepth, int maxDepth, int score, Connect4SearchResult *result)
+{
+    for (int depth = startDepth + (worker.id & 1); depth <= maxDepth; depth++) {
+        score = aspirate(worker, board, depth, score);
+        if (_stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        worker.previousPV.assign(worker.pv[0], worker.pv[0] + worker.pvLength[0]);
+        if (result) {
+            result->score = score;
+            result->depth = depth;
+            result->pv = worker.previousPV;
+            if (!result->pv.empty()) {
+                result->move = result->pv[0];
+            }
+        }
+        // a forced result can't change with more depth
+        if (isWinScore(score)) {
+            break;
+        }
+    }
+}
+
+template <int W, int H>
+int BasicConnect4Search<W, H>::aspirate(Worker &worker, const Board &board, int depth, int previousScore)
+{
+    int delta = _windows.aspirationDelta;
+    int alpha = -SCORE_INFINITY;
+    int beta = SCORE_INFINITY;
+    if (delta > 0 && depth >= _windows.aspirationMinDepth && !isWinScore(previousScore)) {
+        alpha = previousScore - delta;
+        beta = previousScore + delta;
+    }
+
+    for (;;) {
+        const int score = searchRoot(worker, board, depth, alpha, beta);
+        if (_stop.load(std::memory_order_relaxed)) {
+            return score;
+        }
+        // widen only the side that failed, doubling each time; a win score opens it fully
+        if (score <= alpha) {
+            worker.aspirationFailLows++;
+            alpha = isWinScore(score) ? -SCORE_INFINITY : std::max(score - delta, -SCORE_INFINITY);
+        } else if (score >= beta) {
+            worker.aspirationFailHighs++;
+            beta = isWinScore(score) ? SCORE_INFINITY : std::min(score + delta, SCORE_INFINITY);
+        } else {
+            return score;
+        }
+        delta *= 2;
+    }
+}
+
+template <int W, int H>
+int BasicConnect4Search<W, H>::searchRoot(Worker &worker, const Board &board, int depth, int alpha, int beta)
+{
+    worker.pvLength[0] = 0;
+    for (int col = 0; col < W; col++) {
+        if (board.canPlay(col) && board.isWinningMove(col)) {
+            worker.pv[0][0] = col;
+            worker.pvLength[0] = 1;
+            return WIN_SCORE - (board.moveCount() + 1);
+        }
+    }
+    return negamax(worker, board, depth, 0, alpha, beta, true);
+}
+
+template <int W, int H>
+bool BasicConnect4Search<W, H>::shouldStop(Worker &worker)
+{
+    if (_stop.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (worker.id != 0 || (worker.nodes % STOP_CHECK_INTERVAL) != 0) {
+        return false;
+    }
+    if ((_cancel && _cancel->load(std::memory_order_relaxed)) ||
+        (_hasDeadline && std::chrono::steady_clock::now() >= _deadline)) {
+        _stop = true;
+    }
+    return _stop.load(std::memory_order_relaxed);
+}
+
+template <int W, int H>
+int BasicConnect4Search<W, H>::orderMoves(Worker &worker, const Board &board, int ply, int pvMove, int tableMove, int order[W]) const
+{
+    const int player = board.currentPlayer();
+    int keys[W];
+    int count = 0;
+    for (int i = 0; i < W; i++) {
+        const int col = _ordering.centerFirst ? Board::centerOrder(i) : i;
+        if (!board.canPlay(col)) {
+            continue;
+        }
+        int key = 0;
+        if (col == pvMove) {
+            key += PV_BONUS;
+        }
+        if (_ordering.tableMove && col == tableMove) {
+            key += TABLE_MOVE_BONUS;
+        }
+        const int cell = dropCell(board, col);
+        if (_ordering.killers && (cell == worker.killers[ply][0] || cell == worker.killers[ply][1])) {
+            key += cell == worker.killers[ply][0] ? KILLER_BONUS + 1 : KILLER_BONUS;
+        }
+        if (_ordering.history) {
+            key += worker.history[player][cell];
+        }
+
+        // insertion sort; ties keep the static order
+        int j = count++;
+        while (j > 0 && keys[j - 1] < key) {
+            keys[j] = keys[j - 1];
+            order[j] = order[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        order[j] = col;
+    }
+    return count;
+}
+
+template <int W, int H>
+void BasicConnect4Search<W, H>::recordCutoff(Worker &worker, const Board &board, int ply, int depth, int column, int moveIndex)
+{
+    worker.plies[ply].cutoffs++;
+    if (moveIndex == 0) {
+        worker.plies[ply].firstMoveCutoffs++;
+    }
+    const int cell = dropCell(board, column);
+    if (worker.killers[ply][0] != cell) {
+        worker.killers[ply][1] = worker.killers[ply][0];
+        worker.killers[ply][0] = cell;
+    }
+    int &history = worker.history[board.currentPlayer()][cell];
+    history += depth * depth;
+    if (history >= HISTORY_LIMIT) {
+        for (int player = 0; player < 2; player++) {
+            for (int cell = 0; cell < Worker::CELL_COUNT; cell++) {
+                worker.history[player][cell] /= 2;
+            }
+        }
+    }
+}
+
+template <int W, int H>
+int BasicConnect4Search<W, H>::negamax(Worker &worker, const Board &board, int depth, int ply, int alpha, int beta, bool onPV)
+{
+    worker.nodes++;
+    worker.plies[ply].nodes++;
+    worker.pvLength[ply] = 0;
+    if (board.isFull() || shouldStop(worker)) {
+        return 0;
+    }
+
+    // the previous move never wins here (the parent checks for immediate wins),
+    // so only the side to move can complete four on this ply
+    if (Board::winningCells(board.stones(board.currentPlayer()), board.mask()) & board.playableCells()) {
+        return WIN_SCORE - (board.moveCount() + 1);
+    }
+
+    // close to the end the exact result may be a lookup away; the root always searches so it has a move
+    if constexpr (std::is_same_v<Board, Connect4Board>) {
+        int exact;
+        if (ply > 0 && _endgame && _endgame->covers(board) && _endgame->probe(board, exact)) {
+            worker.endgameHits++;
+            return BasicConnect4Solver<W, H>::toSearchScore(board, exact);
+        }
+    }
+
+    if (depth == 0) {
+        return BasicConnect4Evaluation<W, H>::evaluate(board);
+    }
+
+    // win scores are stored relative to the full game length, so entries can
+    // be reused no matter which move order reached this position. the root is
+    // never cut off here so the iteration always produces a move and a PV.
+    const uint64_t hash = board.hash();
+    const int alphaOrig = alpha;
+    int tableMove = -1;
+    TranspositionTable::Entry entry;
+    worker.tableProbes++;
+    if (_table.probe(hash, entry)) {
+        worker.tableHits++;
+        tableMove = entry.move;
+        if (ply > 0 && entry.depth >= depth) {
+            if (entry.bound == TranspositionTable::BOUND_EXACT) {
+                return entry.score;
+            }
+            if (entry.bound == TranspositionTable::BOUND_LOWER) {
+                alpha = std::max(alpha, entry.score);
+            } else if (entry.bound == TranspositionTable::BOUND_UPPER) {
+                beta = std::min(beta, entry.score);
+            }
+            if (alpha >= beta) {
+                return entry.score;
+            }
+        }
+    }
+
+    const int pvMove = onPV && ply < (int)worker.previousPV.size() ? worker.previousPV[ply] : -1;
+    int order[W];
+    const int count = orderMoves(worker, board, ply, pvMove, tableMove, order);
+
+    int best = -SCORE_INFINITY;
+    int bestCol = -1;
+    for (int i = 0; i < count; i++) {
+        const int col = order[i];
+        Board next = board;
+        next.play(col);
+
+        // Negamax: score = - negamax(next, otherTurn, -beta, -alpha). after the first move
+        // only ask whether a move beats alpha, and pay for an exact score only when it does
+        int score;
+        if (i == 0 || !_windows.pvs) {
+            score = -negamax(worker, next, depth - 1, ply + 1, -beta, -alpha, col == pvMove);
+        } else {
+            score = -negamax(worker, next, depth - 1, ply + 1, -alpha - 1, -alpha, false);
+            if (score > alpha && score < beta && !_stop.load(std::memory_order_relaxed)) {
+                worker.pvsResearches++;
+                score = -negamax(worker, next, depth - 1, ply + 1, -beta, -alpha, false);
+            }
+        }
+        if (_stop.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        if (score > best) {
+            best = score;
+            bestCol = col;
+        }
+        if (score > alpha) {
+            alpha = score;
+            worker.pv[ply][0] = col;
+            std::copy(worker.pv[ply + 1], worker.pv[ply + 1] + worker.pvLength[ply + 1], worker.pv[ply] + 1);
+            worker.pvLength[ply] = worker.pvLength[ply + 1] + 1;
+        }
+        if (alpha >= beta) {
+            recordCutoff(worker, board, ply, depth, col, i);
+            break; // alpha-beta cutoff
+        }
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+    if (best <= alphaOrig) {
+        bound = TranspositionTable::BOUND_UPPER;
+    } else if (best >= beta) {
+        bound = TranspositionTable::BOUND_LOWER;
+    }
+    _table.store(hash, best, depth, bound, bestCol);
+    return best;
+}
+
+template class BasicConnect4Search<7, 6>;
+template class BasicConnect4Search<8, 7>;
+template class BasicConnect4Search<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+template class BasicConnect4Search<9, 7>;
+#endif
@@ -0,0 +1,133 @@
+#pragma once
+#include "Connect4Board.h"
+#include "Connect4Endgame.h"
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct Connect4SearchLimits
+{
+    int maxDepth = 0;       // plies; 0 searches to the end of the game
+    // the first iteration and the score its aspiration window is centred on, for a caller
+    // that carries on a deepening it stopped earlier; the table still holds what it found
+    int startDepth = 1;
+    int startScore = 0;
+    int timeBudgetMs = 0;   // wall-clock budget; 0 means no time limit
+    int threads = 1;        // search threads; 0 uses every hardware thread
+    // false leaves the table's generation alone, for a caller that runs several searches
+    // as one job and starts the generation itself (pondering); stores age nothing in between
+    bool newGeneration = true;
+};
+
+// which move-ordering heuristics the search uses; each can be switched on or off to measure
+// what it saves. with the current evaluation killers and history cost more nodes than they
+// save on top of the table move, so they start off.
+struct Connect4MoveOrdering
+{
+    bool centerFirst = true;    // static center-out column order
+    bool tableMove = true;      // transposition-table best move first
+    bool killers = false;       // two cutoff cells remembered per ply
+    bool history = false;       // cutoff counts per player and cell
+};
+
+// search window settings, exposed so they can be tuned from benchmark runs
+struct Connect4SearchWindows
+{
+    bool pvs = true;            // null-window probes for every move after the first
+    int aspirationDelta = 8;    // half-width of the first root window around the last score; 0 = full window
+    int aspirationMinDepth = 4; // shallower iterations are cheap enough to search with a full window
+};
+
+struct Connect4SearchResult
+{
+    int move = -1;          // -1 only when the board is already full
+    int score = 0;          // from the side to move's point of view
+    int depth = 0;          // last completed iteration
+    std::vector<int> pv;    // principal variation of that iteration
+    SearchStats stats;
+};
+
+//
+// iterative-deepening principal variation search over a Connect4 board of any size
+//
+// only the first move at each node gets the full window; the rest are probed with
+// a null window and searched again only if they beat it. each iteration after the
+// first few starts from a narrow aspiration window around the previous score.
+//
+// the transposition table lives as long as the search object, so a game that
+// keeps one Connect4Search around reuses the tree from its previous moves.
+//
+// with more than one thread the search runs Lazy SMP: every thread deepens the
+// same root on its own and they cooperate only through the shared lock-free
+// table. helper threads start one ply deeper on odd ids so they fill the table
+// ahead of the main thread, whose last completed iteration is the result.
+//
+template <int W, int H>
+class BasicConnect4Search
+{
+public:
+    typedef BasicConnect4Board<W, H> Board;
+
+    static const int WIN_SCORE = 10000;
+    static const int SCORE_INFINITY = 30000;
+    static const int MAX_PLY = W * H + 1;
+
+    explicit BasicConnect4Search(size_t tableMegabytes = 16);
+    ~BasicConnect4Search();
+
+    // deepen one ply at a time until the limits run out, returning the last
+    // completed iteration. setting cancel stops the search as if time ran out.
+    Connect4SearchResult search(const Board &board, const Connect4SearchLimits &limits, const std::atomic<bool> *cancel = nullptr);
+    // fixed-depth search; best column for the side to move, or -1 if the board is full
+    int         findBestMove(const Board &board, int depth, const std::atomic<bool> *cancel = nullptr);
+    // forget everything learned from the previous game
+    void        newGame();
+
+    void        setMoveOrdering(const Connect4MoveOrdering &ordering) { _ordering = ordering; }
+    const Connect4MoveOrdering &moveOrdering() const { return _ordering; }
+    void        setWindows(const Connect4SearchWindows &windows) { _windows = windows; }
+    const Connect4SearchWindows &windows() const { return _windows; }
+    // exact results for the positions it covers, read instead of searched (standard board only;
+    // the database must outlive the search). nullptr turns it off.
+    void        setEndgame(const Connect4Endgame *endgame) { _endgame = endgame; }
+
+    static bool isWinScore(int score) { return score >= WIN_SCORE - MAX_PLY || score <= -(WIN_SCORE - MAX_PLY); }
+
+    TranspositionTable &table() { return _table; }
+    const TranspositionTable &table() const { return _table; }
+
+private:
+    struct Worker;
+
+    void        iterate(Worker &worker, const Board &board, int startDepth, int maxDepth, int score, Connect4SearchResult *result);
+    // one iteration, re-searched with wider windows until the score lands inside one
+    int         aspirate(Worker &worker, const Board &board, int depth, int previousScore);
+    int         searchRoot(Worker &worker, const Board &board, int depth, int alpha, int beta);
+    int         negamax(Worker &worker, const Board &board, int depth, int ply, int alpha, int beta, bool onPV);
+    int         orderMoves(Worker &worker, const Board &board, int ply, int pvMove, int tableMove, int order[W]) const;
+    void        recordCutoff(Worker &worker, const Board &board, int ply, int depth, int column, int moveIndex);
+    bool        shouldStop(Worker &worker);
+
+    TranspositionTable _table;
+    Connect4MoveOrdering _ordering;
+    Connect4SearchWindows _windows;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    const std::atomic<bool> *_cancel;
+    std::atomic<bool> _stop;
+    std::chrono::steady_clock::time_point _deadline;
+    bool        _hasDeadline;
+    const Connect4Endgame *_endgame;
+};
+
+typedef BasicConnect4Search<7, 6> Connect4Search;
+
+extern template class BasicConnect4Search<7, 6>;
+extern template class BasicConnect4Search<8, 7>;
+extern template class BasicConnect4Search<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+extern template class BasicConnect4Search<9, 7>;
+#endif
@@ -0,0 +1,263 @@
+#include "Connect4Solver.h"
+#include "Connect4Search.h"
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+// with this few empty cells left the subtree is cheaper to search again than to look up:
+// the table probe is a cache miss, the search a handful of nodes
+const int TABLE_MIN_EMPTY = 8;
+// how often (in nodes) the solver looks at the cancel flag
+const uint64_t STOP_CHECK_MASK = 4095;
+}
+
+template <int W, int H>
+BasicConnect4Solver<W, H>::BasicConnect4Solver(size_t tableMegabytes)
+    : _table(tableMegabytes, TranspositionTable::KEY_FULL), _cancel(nullptr), _stopped(false), _nodes(0)
+{
+}
+
+template <int W, int H>
+bool BasicConnect4Solver<W, H>::finishedScore(const Board &board, int &score)
+{
+    const Connect4Board::Outcome outcome = board.outcome();
+    if (outcome.winner >= 0) {
+        // the winner moved last, so the side to move has lost
+        score = -(SCORE_BASE - Board::popcount(board.stones(outcome.winner)));
+        return true;
+    }
+    if (outcome.draw) {
+        score = 0;
+        return true;
+    }
+    return false;
+}
+
+template <int W, int H>
+int BasicConnect4Solver<W, H>::solve(const Board &board, const std::atomic<bool> *cancel)
+{
+    startCall(cancel);
+    const int score = solveScore(board);
+    return checkCancel() ? 0 : score;
+}
+
+template <int W, int H>
+void BasicConnect4Solver<W, H>::startCall(const std::atomic<bool> *cancel)
+{
+    _cancel = cancel;
+    _stopped = false;
+}
+
+template <int W, int H>
+bool BasicConnect4Solver<W, H>::checkCancel()
+{
+    if (_cancel && _cancel->load(std::memory_order_relaxed))
+        _stopped = true;
+    return _stopped;
+}
+
+template <int W, int H>
+int BasicConnect4Solver<W, H>::solveScore(const Board &board)
+{
+    int score;
+    if (finishedScore(board, score))
+        return score;
+    const int moves = board.moveCount();
+    if (Board::winningCells(board.stones(board.currentPlayer()), board.mask()) & board.playableCells())
+        return (CELLS + 1 - moves) / 2;
+
+    _table.newSearch();
+    int min = -(CELLS - moves) / 2;
+    int max = (CELLS + 1 - moves) / 2;
+    while (min < max && !_stopped) {
+        // bisect, but try near 0 first: the answer is usually a small score
+        int med = min + (max - min) / 2;
+        if (med <= 0 && min / 2 < med)
+            med = min / 2;
+        else if (med >= 0 && max / 2 > med)
+            med = max / 2;
+
+        const int result = negamax(board, med, med + 1);
+        if (result <= med)
+            max = result;
+        else
+            min = result;
+    }
+    return _stopped ? 0 : min;
+}
+
+template <int W, int H>
+int BasicConnect4Solver<W, H>::negamax(const Board &board, int alpha, int beta)
+{
+    if ((++_nodes & STOP_CHECK_MASK) == 0 && _cancel && _cancel->load(std::memory_order_relaxed))
+        _stopped = true;
+    if (_stopped)
+        return 0;
+
+    // moves that hand the opponent a win are never searched
+    const auto next = board.nonLosingMoves();
+    const int moves = board.moveCount();
+    if (next == 0)
+        return -(CELLS - moves) / 2;
+    if (moves >= CELLS - 2)
+        return 0;
+
+    // we cannot win on the next move (the caller checked), nor lose on the one after
+    int min = -(CELLS - 2 - moves) / 2;
+    if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta)
+            return alpha;
+    }
+    int max = (CELLS - 1 - moves) / 2;
+
+    const bool useTable = CELLS - moves > TABLE_MIN_EMPTY;
+    const uint64_t hash = board.hash();
+    TranspositionTable::Entry entry;
+    int tableMove = -1;
+    if (useTable && _table.probe(hash, entry)) {
+        tableMove = entry.move;
+        if (entry.bound == TranspositionTable::BOUND_LOWER) {
+            min = entry.score;
+            if (alpha < min) {
+                alpha = min;
+                if (alpha >= beta)
+                    return alpha;
+            }
+        } else if (entry.bound == TranspositionTable::BOUND_UPPER) {
+            max = entry.score;
+        }
+    }
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta)
+            return beta;
+    }
+
+    // moves that open the most winning cells first; the insertion keeps center-out order on ties
+    const auto own = board.stones(board.currentPlayer());
+    int order[W];
+    int keys[W];
+    int count = 0;
+    for (int i = 0; i < W; i++) {
+        const int col = Board::centerOrder(i);
+        const auto move = next & Board::columnMask(col);
+        if (!move)
+            continue;
+        // the move that last cut this node off goes ahead of everything else
+        const int key = col == tableMove ? CELLS
+                                         : Board::popcount(Board::winningCells(own | move, board.mask() | move));
+        int at = count++;
+        while (at > 0 && keys[at - 1] < key) {
+            order[at] = order[at - 1];
+            keys[at] = keys[at - 1];
+            at--;
+        }
+        order[at] = col;
+        keys[at] = key;
+    }
+
+    for (int i = 0; i < count; i++) {
+        Board child = board;
+        child.play(order[i]);
+        const int score = -negamax(child, -beta, -alpha);
+        if (_stopped)
+            return 0;
+        if (score >= beta) {
+            if (useTable)
+                _table.store(hash, score, CELLS - moves, TranspositionTable::BOUND_LOWER, order[i]);
+            return score;
+        }
+        if (score > alpha)
+            alpha = score;
+    }
+    if (useTable)
+        _table.store(hash, alpha, CELLS - moves, TranspositionTable::BOUND_UPPER, -1);
+    return alpha;
+}
+
+template <int W, int H>
+void BasicConnect4Solver<W, H>::analyze(const Board &board, int scores[W], const std::atomic<bool> *cancel)
+{
+    startCall(cancel);
+    analyzeScores(board, scores);
+    checkCancel();
+}
+
+template <int W, int H>
+void BasicConnect4Solver<W, H>::analyzeScores(const Board &board, int scores[W])
+{
+    int finished;
+    const bool over = finishedScore(board, finished);
+    for (int col = 0; col < W; col++) {
+        if (over || !board.canPlay(col)) {
+            scores[col] = INVALID_COLUMN;
+        } else if (board.isWinningMove(col)) {
+            scores[col] = (CELLS + 1 - board.moveCount()) / 2;
+        } else if (checkCancel()) {
+            // once stopped, the columns left are not searched at all
+            scores[col] = 0;
+        } else {
+            Board child = board;
+            child.play(col);
+            scores[col] = -solveScore(child);
+        }
+    }
+}
+
+template <int W, int H>
+Connect4SolveResult BasicConnect4Solver<W, H>::bestMove(const Board &board, const std::atomic<bool> *cancel)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startNodes = _nodes;
+
+    Connect4SolveResult result;
+    int scores[W];
+    startCall(cancel);
+    analyzeScores(board, scores);
+    if (!finishedScore(board, result.score)) {
+        for (int i = 0; i < W; i++) {
+            const int col = Board::centerOrder(i);
+            if (scores[col] != INVALID_COLUMN && (result.move < 0 || scores[col] > result.score)) {
+                result.move = col;
+                result.score = scores[col];
+            }
+        }
+    }
+
+    result.pliesToEnd = pliesToEnd(board, result.score);
+    result.nodes = _nodes - startNodes;
+    result.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (checkCancel())
+        result.move = -1;
+    return result;
+}
+
+template <int W, int H>
+int BasicConnect4Solver<W, H>::pliesToEnd(const Board &board, int score)
+{
+    if (score == 0)
+        return -1;
+    const int moves = board.moveCount();
+    if (score > 0) {
+        // the side to move places its winning disc; its own discs so far are moves / 2
+        return 2 * (SCORE_BASE - score - moves / 2) - 1;
+    }
+    return 2 * (SCORE_BASE + score - (moves - moves / 2));
+}
+
+template <int W, int H>
+int BasicConnect4Solver<W, H>::toSearchScore(const Board &board, int score)
+{
+    if (score == 0)
+        return 0;
+    const int stonesAtWin = board.moveCount() + pliesToEnd(board, score);
+    return score > 0 ? BasicConnect4Search<W, H>::WIN_SCORE - stonesAtWin : -(BasicConnect4Search<W, H>::WIN_SCORE - stonesAtWin);
+}
+
+template class BasicConnect4Solver<7, 6>;
+template class BasicConnect4Solver<8, 7>;
+template class BasicConnect4Solver<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+template class BasicConnect4Solver<9, 7>;
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+#include "Connect4Board.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+
+struct Connect4SolveResult
+{
+    // exact score for the side to move: 0 is a draw, positive a win and negative a loss.
+    // the size is 22 (on 7x6; half the cells plus one) minus the number of stones the winner
+    // has on the board when the game ends, so faster wins score higher (the usual solver convention).
+    int score = 0;
+    int move = -1;              // a best column; -1 when the game is already over
+    int pliesToEnd = -1;        // plies until the winner's fourth disc; -1 for a draw
+    uint64_t nodes = 0;
+    double timeMs = 0.0;
+};
+
+//
+// exact Connect4 solver
+//
+// unlike Connect4Search there is no evaluation: every line is played to the end.
+// the score range is narrowed with null-window searches (bisecting toward 0 first,
+// since most positions are close to a draw), moves that lose at once are never
+// tried, and remaining moves are ordered by how many winning cells they create.
+// bounds go into a large transposition table that is kept between calls, so
+// solving the positions of one game gets faster as it goes. its entries are
+// checked against the whole 64-bit hash (KEY_FULL), which for the standard
+// board is a one-to-one function of the position.
+//
+template <int W, int H>
+class BasicConnect4Solver
+{
+public:
+    typedef BasicConnect4Board<W, H> Board;
+
+    static const int MIN_SCORE = -(W * H) / 2 + 3;
+    static const int MAX_SCORE = (W * H + 1) / 2 - 3;
+
+    explicit BasicConnect4Solver(size_t tableMegabytes = 64);
+
+    // exact score of the position; setting cancel abandons the solve and returns 0
+    int         solve(const Board &board, const std::atomic<bool> *cancel = nullptr);
+    // score of every column (INVALID_COLUMN for full ones) from the side to move's point of view.
+    // cancelling stops the whole call; stopped() then stays set and the scores mean nothing
+    void        analyze(const Board &board, int scores[W], const std::atomic<bool> *cancel = nullptr);
+    // best column, its score and the distance to the end; ties go to the more central column
+    Connect4SolveResult bestMove(const Board &board, const std::atomic<bool> *cancel = nullptr);
+
+    // plies from this position until the game is decided with the given exact score, -1 for a draw
+    static int  pliesToEnd(const Board &board, int score);
+    // the same result on Connect4Search's WIN_SCORE scale, so the two can be mixed
+    static int  toSearchScore(const Board &board, int score);
+
+    bool        stopped() const { return _stopped; }
+    uint64_t    nodes() const { return _nodes; }
+    void        clear() { _table.clear(); }
+
+    TranspositionTable &table() { return _table; }
+
+    static const int INVALID_COLUMN = -1000;
+
+private:
+    static const int CELLS = W * H;
+    // a win scores SCORE_BASE minus the winner's stone count
+    static const int SCORE_BASE = (CELLS + 1) / 2 + 1;
+
+    // clears the stop flag once per public call, so one cancelled column stops them all
+    void        startCall(const std::atomic<bool> *cancel);
+    // sets the stop flag if the caller has cancelled; true once stopped
+    bool        checkCancel();
+    int         solveScore(const Board &board);
+    void        analyzeScores(const Board &board, int scores[W]);
+    int         negamax(const Board &board, int alpha, int beta);
+    // the finished-game score when the board already has a winner or is full
+    static bool finishedScore(const Board &board, int &score);
+
+    TranspositionTable _table;
+    const std::atomic<bool> *_cancel;
+    bool        _stopped;
+    uint64_t    _nodes;
+};
+
+typedef BasicConnect4Solver<7, 6> Connect4Solver;
+
+extern template class BasicConnect4Solver<7, 6>;
+extern template class BasicConnect4Solver<8, 7>;
+extern template class BasicConnect4Solver<6, 5>;
+#ifdef CONNECT4_WIDE_BOARDS
+extern template class BasicConnect4Solver<9, 7>;
+#endif
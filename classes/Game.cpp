@@ -14,7 +14,11 @@ Game::Game()
 	_gameOptions.rowX = 0;
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
-	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AITimeBudgetMs = 1000;
+	_gameOptions.AIThreads = 0;
+	_gameOptions.AIPerfectPlay = false;
+	_gameOptions.AIPonder = false;
+	_gameOptions.AIPonderThreads = 1;
 	_gameOptions.AIvsAI = false;
 
 	_table = nullptr;
@@ -28,10 +32,15 @@ Game::Game()
 	_dragStartPos = ImVec2(0, 0);
 	_dragOffset = ImVec2(0, 0);
 	_oldPos = ImVec2(0, 0);
+	_aiSearchCancel = false;
+	_ponderCancel = false;
+	_ponderHits = 0;
+	_ponderChecks = 0;
 }
 
 Game::~Game()
 {
+	cancelAISearch();
 	for (auto &_turn : _turns)
 	{
 		delete _turn;
@@ -100,6 +109,14 @@ void Game::endTurn()
 	ClassGame::EndOfTurn();
 }
 
+GameOutcome Game::checkForOutcome()
+{
+	GameOutcome outcome;
+	outcome.winner = checkForWinner();
+	outcome.draw = !outcome.winner && checkForDraw();
+	return outcome;
+}
+
 //
 // scan for mouse is temporarily in the actual game class
 // this will be moved to a higher up class when the squares have a heirarchy
@@ -249,6 +266,92 @@ void Game::updateAI()
 {
 }
 
+bool Game::startAISearch(AISearchJob job)
+{
+	if (_aiSearch.valid())
+	{
+		return false;
+	}
+	_aiSearchCancel = false;
+	_aiSearch = std::async(std::launch::async, [this, job]() {
+		return job(_aiSearchCancel);
+	});
+	return true;
+}
+
+bool Game::pollAISearch(int &move)
+{
+	if (!_aiSearch.valid() || _aiSearch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return false;
+	}
+	move = _aiSearch.get();
+	return true;
+}
+
+void Game::cancelAISearch()
+{
+	stopPonder();
+	if (!_aiSearch.valid())
+	{
+		return;
+	}
+	_aiSearchCancel = true;
+	_aiSearch.wait();
+	_aiSearch = std::future<int>();
+	_aiSearchCancel = false;
+}
+
+bool Game::startPonder(AISearchJob job)
+{
+	if (_ponder.valid())
+	{
+		return false;
+	}
+	_ponderCancel = false;
+	_ponder = std::async(std::launch::async, [this, job]() {
+		return job(_ponderCancel);
+	});
+	return true;
+}
+
+void Game::stopPonder()
+{
+	if (!_ponder.valid())
+	{
+		return;
+	}
+	_ponderCancel = true;
+	_ponder.wait();
+	_ponder = std::future<int>();
+	_ponderCancel = false;
+}
+
+void Game::recordPonderOutcome(bool hit)
+{
+	_ponderChecks++;
+	if (hit)
+	{
+		_ponderHits++;
+	}
+}
+
+void Game::recordSearchStats(const SearchStats &stats)
+{
+	std::lock_guard<std::mutex> guard(_searchStatsLock);
+	if ((int)_searchStats.size() == MAX_SEARCH_HISTORY)
+	{
+		_searchStats.erase(_searchStats.begin());
+	}
+	_searchStats.push_back(stats);
+}
+
+std::vector<SearchStats> Game::searchStatsHistory() const
+{
+	std::lock_guard<std::mutex> guard(_searchStatsLock);
+	return _searchStats;
+}
+
 void Game::mouseDown(ImVec2 &location, Entity *entity)
 {
 	bool placing = false;
@@ -12,6 +12,8 @@
 #include <chrono>
 #include <ctime>
 #include <future>
+#include <functional>
+#include <mutex>
 
 #ifdef _MSC_VER
 #include <intrin.h>
@@ -22,6 +24,7 @@
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Grid.h"
+#include "SearchStats.h"
 
 
 const int AI_PLAYER = 1;
@@ -29,6 +32,13 @@ const int HUMAN_PLAYER = -1;
 
 class GameTable;
 
+// result of the turn that just ended; winner is null unless someone has won
+struct GameOutcome
+{
+	Player *winner;
+	bool draw;
+};
+
 struct GameOptions
 {
 	bool AIPlaying;
@@ -39,8 +49,11 @@ struct GameOptions
 	int gameNumber;
 	unsigned int currentTurnNo;
 	int score;
-	int AIDepthSearches;
-	int AIMAXDepth;
+	int AITimeBudgetMs;	// wall-clock time the AI may spend per move
+	int AIThreads;		// search threads for the AI; 0 uses every hardware thread
+	bool AIPerfectPlay;	// use an exact solver where the game has one, ignoring the time budget
+	bool AIPonder;		// search the opponent's likely replies while it is thinking
+	int AIPonderThreads;	// search threads for pondering; 0 uses every hardware thread
 	bool AIvsAI;
 };
 
@@ -90,21 +103,51 @@ public:
 
 	virtual Player *checkForWinner() = 0;
 	virtual bool checkForDraw() = 0;
+	// both at once, asked once per turn; the default calls checkForWinner and checkForDraw
+	virtual GameOutcome checkForOutcome();
 	virtual bool animateAndPlaceBitFromTo(Bit &bit, BitHolder &src, BitHolder &dst);
 
 	virtual void stopGame() = 0;
 	virtual bool gameHasAI();
 	virtual void updateAI();
+	// called each frame while a human is to move and pondering is on
+	virtual void ponderAI() {}
 	virtual void pieceTaken(Bit *bit){};
 
+	// background AI search. the job runs on a worker thread against a snapshot of the position,
+	// should return early once the cancel flag it is handed becomes true, and returns the chosen move.
+	typedef std::function<int(const std::atomic<bool> &cancel)> AISearchJob;
+	bool startAISearch(AISearchJob job);
+	bool aiSearchRunning() const { return _aiSearch.valid(); }
+	// returns true once the finished job's move has been collected into move
+	bool pollAISearch(int &move);
+	// ask a running job (and any ponder job) to stop and wait for its worker to finish
+	void cancelAISearch();
+
+	// speculative search on the opponent's time, on a worker of its own. the job follows the
+	// same cancel protocol as an AI search job and its return value is ignored; it keeps what
+	// it learns in the game's engine, so the game stops it before moving or searching.
+	bool startPonder(AISearchJob job);
+	bool ponderRunning() const { return _ponder.valid(); }
+	void stopPonder();
+	// whether the AI's move had already been pondered deeply enough, for the Settings window
+	void recordPonderOutcome(bool hit);
+	int ponderHits() const { return _ponderHits; }
+	int ponderChecks() const { return _ponderChecks; }
+
+	// cost of the AI's recent searches, oldest first, for the Settings window. jobs report
+	// from their worker thread; only the last MAX_SEARCH_HISTORY searches are kept.
+	static const int MAX_SEARCH_HISTORY = 120;
+	void recordSearchStats(const SearchStats &stats);
+	std::vector<SearchStats> searchStatsHistory() const;
+
 	virtual std::string initialStateString() = 0;
 	virtual std::string stateString() = 0;
 	virtual void setStateString(const std::string &s) = 0;
 
 	void setNumberOfPlayers(unsigned int playerCount);
 	void setAIPlayer(unsigned int playerNumber);
-	virtual int getAIDepathSearches() { return _gameOptions.AIDepthSearches; };
-	virtual int getAIMAXDepth() { return _gameOptions.AIMAXDepth; };
+	virtual int getAITimeBudgetMs() { return _gameOptions.AITimeBudgetMs; };
 
 	// mouse functions
 	void scanForMouse();
@@ -151,4 +194,15 @@ protected:
 	BitHolder *_dropTarget;
 	BitHolder *_oldHolder;
 	bool _dragMoved;
+
+	std::future<int> _aiSearch;
+	std::atomic<bool> _aiSearchCancel;
+
+	std::future<int> _ponder;
+	std::atomic<bool> _ponderCancel;
+	int _ponderHits;
+	int _ponderChecks;
+
+	mutable std::mutex _searchStatsLock;
+	std::vector<SearchStats> _searchStats;
 };
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//
+// read-only memory mapping of a whole file
+//
+// opening costs a system call, not a read: pages are faulted in from the OS
+// cache the first time they are touched, and several processes serving games
+// share the same physical copy.
+//
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // false if the file is missing or empty; any previous mapping is closed first
+    bool        open(const std::string &path);
+    void        close();
+
+    bool        isOpen() const { return _data != nullptr; }
+    const uint8_t *data() const { return _data; }
+    size_t      size() const { return _size; }
+
+private:
+    const uint8_t *_data;
+    size_t      _size;
+#ifdef _WIN32
+    void       *_file;
+    void       *_mapping;
+#endif
+};
@@ -1,19 +1,26 @@
 #include "Othello.h"
 #include <iostream>
 
-// Define the 8 directions: N, NE, E, SE, S, SW, W, NW
-const int Othello::DIRECTIONS[8][2] = {
-    {0, -1}, {1, -1}, {1, 0}, {1, 1},
-    {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
-};
+namespace {
+// empty squares from which the AI plays the last moves exactly. the usual figure
+// takes a few milliseconds; perfect play waits for a solve of up to about a second.
+const int SOLVE_EMPTIES = 14;
+const int PERFECT_PLAY_SOLVE_EMPTIES = 20;
+}
 
 Othello::Othello() : Game() {
     _grid = new Grid(8, 8);
+    _search = std::make_unique<OthelloSearch>();
+    // fitted offline by otrain; without it the search uses the hand-tuned evaluation
+    if (_patterns.open("resources/othello.weights"))
+        _search->setPatterns(&_patterns);
     _consecutivePasses = 0;
     _showingHints = false;
 }
 
 Othello::~Othello() {
+    // the worker may still be using the search
+    cancelAISearch();
     delete _grid;
 }
 
@@ -24,26 +31,15 @@ void Othello::setUpBoard() {
 
     _grid->initializeSquares(80, "boardsquare.png");
 
-    // Set up initial four pieces in the center
-    Player* blackPlayer = getPlayerAt(BLACK_PLAYER);
-    Player* whitePlayer = getPlayerAt(WHITE_PLAYER);
-
     // Standard Othello starting position
-    auto placePiece = [&](int x, int y, Player* player) {
-        Bit* piece = createPiece(player);
-        piece->setPosition(_grid->getSquare(x, y)->getPosition());
-        _grid->getSquare(x, y)->setBit(piece);
-    };
-
-    placePiece(3, 3, whitePlayer);  // White at (3,3)
-    placePiece(4, 4, whitePlayer);  // White at (4,4)
-    placePiece(4, 3, blackPlayer);  // Black at (4,3)
-    placePiece(3, 4, blackPlayer);  // Black at (3,4)
+    _board = OthelloBoard();
+    _search->newGame();
+    syncPieces();
 
     if (gameHasAI()) {
         setAIPlayer(AI_PLAYER);
     }
-    
+
     startGame();
 }
 
@@ -54,30 +50,42 @@ Bit* Othello::createPiece(Player* player) {
     return bit;
 }
 
+void Othello::syncPieces() {
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        const int owner = _board.cellOwner(x, y);
+        Bit* bit = square->bit();
+        if (bit && owner >= 0 && bit->getOwner() == getPlayerAt(owner)) {
+            return;
+        }
+        square->destroyBit();
+        if (owner >= 0) {
+            Bit* piece = createPiece(getPlayerAt(owner));
+            piece->setPosition(square->getPosition());
+            square->setBit(piece);
+        }
+    });
+}
+
 bool Othello::actionForEmptyHolder(BitHolder &holder) {
     if (holder.bit()) return false;
+    // the AI is thinking about this position; it plays its own move once the search is done
+    if (aiSearchRunning()) return false;
 
     ChessSquare* square = static_cast<ChessSquare*>(&holder);
     int x = square->getColumn();
     int y = square->getRow();
     Player* currentPlayer = getCurrentPlayer();
 
-    if (!isValidMove(x, y, currentPlayer)) return false;
-
-    // Place the piece
-    Bit* newPiece = createPiece(currentPlayer);
-    newPiece->setPosition(holder.getPosition());
-    holder.setBit(newPiece);
-
-    // Flip all affected pieces
-    flipPieces(x, y, currentPlayer);
+    // Place the piece and flip all affected pieces
+    if (!_board.play(x, y, currentPlayer->playerNumber())) return false;
+    syncPieces();
     _consecutivePasses = 0;
 
     // Check if next player has moves
-    Player* nextPlayer = getPlayerAt(1 - currentPlayer->playerNumber());
-    if (!hasValidMove(nextPlayer)) {
+    const int nextPlayer = 1 - currentPlayer->playerNumber();
+    if (!_board.hasValidMove(nextPlayer)) {
         _consecutivePasses++;
-        if (hasValidMove(currentPlayer)) {
+        if (_board.hasValidMove(currentPlayer->playerNumber())) {
             // Next player passes, current player continues
             return true;
         } else {
@@ -97,152 +105,34 @@ bool Othello::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     return false; // Pieces cannot be moved in Othello
 }
 
-bool Othello::isValidMove(int x, int y, Player* player) const {
-    if (!_grid->isValid(x, y) || _grid->getSquare(x, y)->bit()) return false;
-
-    // Check if placing a piece here would flip at least one opponent piece
-    for (int i = 0; i < 8; i++) {
-        if (checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player) > 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
-int Othello::checkDirection(int x, int y, int dx, int dy, Player* player) const {
-    int count = 0;
-    int nx = x + dx;
-    int ny = y + dy;
+Player* Othello::winnerByCount() const {
+    int blackCount, whiteCount;
+    _board.countPieces(blackCount, whiteCount);
 
-    if (!_grid->isValid(nx, ny)) return 0;
-
-    Bit* firstPiece = _grid->getSquare(nx, ny)->bit();
-    if (!firstPiece || firstPiece->getOwner() == player) return 0;
-
-    // Count opponent pieces in this direction
-    while (_grid->isValid(nx, ny)) {
-        Bit* piece = _grid->getSquare(nx, ny)->bit();
-        if (!piece) return 0;
-        if (piece->getOwner() == player) return count;
-        count++;
-        nx += dx;
-        ny += dy;
-    }
-    return 0;
-}
-
-void Othello::flipPieces(int x, int y, Player* player) {
-    for (int i = 0; i < 8; i++) {
-        int count = checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
-        if (count > 0) {
-            flipInDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player, count);
-        }
-    }
-}
-
-void Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int count) {
-    int nx = x + dx;
-    int ny = y + dy;
-
-    for (int i = 0; i < count; i++) {
-        ChessSquare* square = _grid->getSquare(nx, ny);
-        if (square && square->bit()) {
-            square->destroyBit();
-            Bit* newPiece = createPiece(player);
-            newPiece->setPosition(square->getPosition());
-            square->setBit(newPiece);
-        }
-        nx += dx;
-        ny += dy;
-    }
-}
-
-bool Othello::hasValidMove(Player* player) const {
-    bool hasMove = false;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (!hasMove && isValidMove(x, y, player)) {
-            hasMove = true;
-        }
-    });
-    return hasMove;
-}
-
-std::vector<std::pair<int, int>> Othello::getValidMoves(Player* player) const {
-    std::vector<std::pair<int, int>> moves;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (isValidMove(x, y, player)) {
-            moves.push_back({x, y});
-        }
-    });
-    return moves;
+    if (blackCount > whiteCount) return getPlayerAt(BLACK_PLAYER);
+    if (whiteCount > blackCount) return getPlayerAt(WHITE_PLAYER);
+    return nullptr;
 }
 
 Player* Othello::checkForWinner() {
-    // Game ends when neither player can move
-    if (_consecutivePasses >= 2 ||
-        (!hasValidMove(getPlayerAt(BLACK_PLAYER)) && !hasValidMove(getPlayerAt(WHITE_PLAYER)))) {
-
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-
-        if (blackCount > whiteCount) return getPlayerAt(BLACK_PLAYER);
-        if (whiteCount > blackCount) return getPlayerAt(WHITE_PLAYER);
+    // Game ends when neither player can move (which includes a full board)
+    if (_consecutivePasses >= 2 || _board.isGameOver()) {
+        return winnerByCount();
     }
-
-    // Check if board is full
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
-    });
-
-    if (boardFull) {
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-        if (blackCount > whiteCount) return getPlayerAt(BLACK_PLAYER);
-        if (whiteCount > blackCount) return getPlayerAt(WHITE_PLAYER);
-    }
-
     return nullptr;
 }
 
 bool Othello::checkForDraw() {
-    if (_consecutivePasses >= 2 ||
-        (!hasValidMove(getPlayerAt(BLACK_PLAYER)) && !hasValidMove(getPlayerAt(WHITE_PLAYER)))) {
+    if (_consecutivePasses >= 2 || _board.isGameOver()) {
         int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-        return blackCount == whiteCount;
-    }
-
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
-    });
-
-    if (boardFull) {
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
+        _board.countPieces(blackCount, whiteCount);
         return blackCount == whiteCount;
     }
     return false;
 }
 
-void Othello::countPieces(int &blackCount, int &whiteCount) const {
-    blackCount = 0;
-    whiteCount = 0;
-
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        Bit* piece = square->bit();
-        if (piece) {
-            if (piece->getOwner() == getPlayerAt(BLACK_PLAYER)) {
-                blackCount++;
-            } else {
-                whiteCount++;
-            }
-        }
-    });
-}
-
 void Othello::stopGame() {
+    cancelAISearch();
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
@@ -250,81 +140,47 @@ void Othello::stopGame() {
 }
 
 std::string Othello::initialStateString() {
-    std::string state(64, '0');
-    state[3 * 8 + 3] = '2';  // White at (3,3)
-    state[4 * 8 + 4] = '2';  // White at (4,4)
-    state[4 * 8 + 3] = '1';  // Black at (4,3)
-    state[3 * 8 + 4] = '1';  // Black at (3,4)
-    return state;
+    return OthelloBoard().stateString();
 }
 
 std::string Othello::stateString() {
-    std::string state;
-    _grid->forEachSquare([&state, this](ChessSquare* square, int x, int y) {
-        Bit* bit = square->bit();
-        if (!bit) {
-            state += '0';
-        } else if (bit->getOwner() == getPlayerAt(BLACK_PLAYER)) {
-            state += '1';
-        } else {
-            state += '2';
-        }
-    });
-    return state;
+    return _board.stateString();
 }
 
 void Othello::setStateString(const std::string &s) {
-    if (s.length() != 64) return;
-
-    int index = 0;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (index < s.length()) {
-            char pieceType = s[index++];
-            square->destroyBit();
-
-            if (pieceType == '1') {
-                Bit* piece = createPiece(getPlayerAt(BLACK_PLAYER));
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            } else if (pieceType == '2') {
-                Bit* piece = createPiece(getPlayerAt(WHITE_PLAYER));
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            }
-        }
-    });
+    if (!_board.setStateString(s)) return;
+    syncPieces();
 }
 
 void Othello::updateAI() {
     if (!gameHasAI()) return;
 
-    Player* aiPlayer = getCurrentPlayer();
-    std::vector<std::pair<int, int>> validMoves = getValidMoves(aiPlayer);
+    // the search runs on a worker thread so frames keep drawing while it thinks
+    int square = -1;
+    if (pollAISearch(square)) {
+        if (square >= 0) {
+            actionForEmptyHolder(*_grid->getSquare(square % OthelloBoard::SIZE, square / OthelloBoard::SIZE));
+        }
+        return;
+    }
+    if (aiSearchRunning()) return;
 
-    if (validMoves.empty()) {
+    const int aiPlayer = getCurrentPlayer()->playerNumber();
+    if (!_board.hasValidMove(aiPlayer)) {
         _consecutivePasses++;
         endTurn();
         return;
     }
 
-    // Find move that flips the most pieces
-    int bestX = -1, bestY = -1, maxFlips = 0;
-
-    for (const auto& move : validMoves) {
-        int x = move.first, y = move.second, totalFlips = 0;
-        for (int i = 0; i < 8; i++) {
-            totalFlips += checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], aiPlayer);
-        }
-        if (totalFlips > maxFlips) {
-            maxFlips = totalFlips;
-            bestX = x;
-            bestY = y;
-        }
-    }
-
-    if (bestX >= 0 && bestY >= 0) {
-        actionForEmptyHolder(*_grid->getSquare(bestX, bestY));
-    }
+    OthelloSearchLimits limits;
+    limits.timeBudgetMs = getAITimeBudgetMs();
+    limits.solveEmpties = _gameOptions.AIPerfectPlay ? PERFECT_PLAY_SOLVE_EMPTIES : SOLVE_EMPTIES;
+    const OthelloBoard board = _board;
+    startAISearch([this, board, aiPlayer, limits](const std::atomic<bool> &cancel) {
+        const OthelloSearchResult result = _search->search(board, aiPlayer, limits, &cancel);
+        recordSearchStats(result.stats);
+        return result.move;
+    });
 }
 
 void Othello::getBoardPosition(BitHolder& holder, int &x, int &y) const {
@@ -339,4 +195,4 @@ void Othello::showValidMoves(Player* player) {
 
 void Othello::clearValidMoveIndicators() {
     _showingHints = false;
-}
\ No newline at end of file
+}
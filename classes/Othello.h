@@ -1,6 +1,9 @@
 #pragma once
 #include "Game.h"
-#include <vector>
+#include "OthelloBoard.h"
+#include "OthelloPatterns.h"
+#include "OthelloSearch.h"
+#include <memory>
 
 // NOTE: This implementation assumes black.png and white.png exist in resources.
 // If not, you can use o.png and x.png, or any other suitable graphics.
@@ -23,36 +26,33 @@ public:
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
 
-    // AI methods
+    // AI methods: an alpha-beta search under the AI time budget, run with Game::startAISearch
     void        updateAI() override;
     bool        gameHasAI() override { return true; } // Set to true when AI is implemented
     Grid* getGrid() override { return _grid; }
 
 private:
     // Player constants
-    static const int BLACK_PLAYER = 0;
-    static const int WHITE_PLAYER = 1;
-
-    // Direction vectors for checking all 8 directions
-    static const int DIRECTIONS[8][2];
+    static const int BLACK_PLAYER = OthelloBoard::BLACK_PLAYER;
+    static const int WHITE_PLAYER = OthelloBoard::WHITE_PLAYER;
 
     // Helper methods
     Bit*        createPiece(Player* player);
-    bool        isValidMove(int x, int y, Player* player) const;
-    int         checkDirection(int x, int y, int dx, int dy, Player* player) const;
-    void        flipPieces(int x, int y, Player* player);
-    void        flipInDirection(int x, int y, int dx, int dy, Player* player, int count);
-    bool        hasValidMove(Player* player) const;
-    void        countPieces(int &blackCount, int &whiteCount) const;
-    std::vector<std::pair<int, int>> getValidMoves(Player* player) const;
+    // make the sprites on the grid match _board
+    void        syncPieces();
+    Player*     winnerByCount() const;
     void        showValidMoves(Player* player);
     void        clearValidMoveIndicators();
 
     // Board position helper
     void        getBoardPosition(BitHolder& holder, int &x, int &y) const;
 
-    // Board representation
+    // Board representation: _board holds the rules state, _grid only draws it
     Grid*       _grid;
+    OthelloBoard _board;
+    OthelloPatterns _patterns;  // empty when no weights file ships with the game
+    // kept across moves so the search reuses its table; only the AI worker uses it while a search runs
+    std::unique_ptr<OthelloSearch> _search;
 
     // Game state
     int         _consecutivePasses;
@@ -0,0 +1,208 @@
+#include "OthelloBoard.h"
+#include "OthelloSimd.h"
+
+namespace {
+// squares a shift may land on without wrapping around the board edge
+const uint64_t NOT_A_FILE = 0xfefefefefefefefeULL;    // x != 0, for shifts that move east
+const uint64_t NOT_H_FILE = 0x7f7f7f7f7f7f7f7fULL;    // x != 7, for shifts that move west
+
+template <int Shift>
+uint64_t shift(uint64_t b)
+{
+    if constexpr (Shift > 0)
+        return b << Shift;
+    else
+        return b >> -Shift;
+}
+
+// gen extended along Shift through the squares of pro, in three doubling steps;
+// pro is masked so no run crosses an edge
+template <int Shift, uint64_t Mask>
+uint64_t fill(uint64_t gen, uint64_t pro)
+{
+    pro &= Mask;
+    gen |= pro & shift<Shift>(gen);
+    pro &= shift<Shift>(pro);
+    gen |= pro & shift<2 * Shift>(gen);
+    pro &= shift<2 * Shift>(pro);
+    gen |= pro & shift<4 * Shift>(gen);
+    return gen;
+}
+
+template <int Shift, uint64_t Mask>
+uint64_t movesInDirection(uint64_t own, uint64_t other, uint64_t empty)
+{
+    // opponent runs that start next to one of our discs, then one more step onto an empty square
+    return shift<Shift>(fill<Shift, Mask>(own, other) & other) & Mask & empty;
+}
+
+template <int Shift, uint64_t Mask>
+uint64_t flipsInDirection(uint64_t own, uint64_t other, uint64_t move)
+{
+    // the run next to the move is captured only if one of our discs closes it
+    const uint64_t run = fill<Shift, Mask>(move, other);
+    const uint64_t closed = shift<Shift>(run) & Mask & own;
+    return closed ? run & other : 0;
+}
+
+uint64_t legalMovesScalar(uint64_t own, uint64_t other)
+{
+    const uint64_t empty = ~(own | other);
+    return movesInDirection<1, NOT_A_FILE>(own, other, empty) |     // east
+           movesInDirection<-1, NOT_H_FILE>(own, other, empty) |    // west
+           movesInDirection<8, ~0ULL>(own, other, empty) |          // south (down the string)
+           movesInDirection<-8, ~0ULL>(own, other, empty) |         // north
+           movesInDirection<9, NOT_A_FILE>(own, other, empty) |     // south-east
+           movesInDirection<7, NOT_H_FILE>(own, other, empty) |     // south-west
+           movesInDirection<-7, NOT_A_FILE>(own, other, empty) |    // north-east
+           movesInDirection<-9, NOT_H_FILE>(own, other, empty);     // north-west
+}
+
+uint64_t flipsScalar(uint64_t own, uint64_t other, int square)
+{
+    const uint64_t move = uint64_t(1) << square;
+    if ((own | other) & move) return 0;
+    return flipsInDirection<1, NOT_A_FILE>(own, other, move) |
+           flipsInDirection<-1, NOT_H_FILE>(own, other, move) |
+           flipsInDirection<8, ~0ULL>(own, other, move) |
+           flipsInDirection<-8, ~0ULL>(own, other, move) |
+           flipsInDirection<9, NOT_A_FILE>(own, other, move) |
+           flipsInDirection<7, NOT_H_FILE>(own, other, move) |
+           flipsInDirection<-7, NOT_A_FILE>(own, other, move) |
+           flipsInDirection<-9, NOT_H_FILE>(own, other, move);
+}
+}
+
+uint64_t (*OthelloBoard::_legalMoves)(uint64_t, uint64_t) = legalMovesScalar;
+uint64_t (*OthelloBoard::_flips)(uint64_t, uint64_t, int) = flipsScalar;
+OthelloBoard::Kernel OthelloBoard::_kernel = OthelloBoard::KERNEL_SCALAR;
+
+namespace {
+// switch to the fastest kernel before main runs
+const bool kernelChosen = OthelloBoard::setKernel(OthelloBoard::KERNEL_AVX2) ||
+                          OthelloBoard::setKernel(OthelloBoard::KERNEL_SSE2);
+}
+
+const char *OthelloBoard::kernelName(Kernel kernel)
+{
+    static const char *const NAMES[KERNEL_COUNT] = {"scalar", "sse2", "avx2"};
+    return kernel >= 0 && kernel < KERNEL_COUNT ? NAMES[kernel] : "?";
+}
+
+bool OthelloBoard::kernelSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case KERNEL_SCALAR:
+        return true;
+#ifdef OTHELLO_SIMD_X86
+    case KERNEL_SSE2:
+        return true;
+    case KERNEL_AVX2:
+        return OthelloSimd::cpuHasAVX2();
+#endif
+    default:
+        return false;
+    }
+}
+
+bool OthelloBoard::setKernel(Kernel kernel)
+{
+    if (!kernelSupported(kernel)) return false;
+    switch (kernel) {
+#ifdef OTHELLO_SIMD_X86
+    case KERNEL_SSE2:
+        _legalMoves = OthelloSimd::legalMovesSSE2;
+        _flips = OthelloSimd::flipsSSE2;
+        break;
+    case KERNEL_AVX2:
+        _legalMoves = OthelloSimd::legalMovesAVX2;
+        _flips = OthelloSimd::flipsAVX2;
+        break;
+#endif
+    default:
+        _legalMoves = legalMovesScalar;
+        _flips = flipsScalar;
+        break;
+    }
+    _kernel = kernel;
+    return true;
+}
+
+OthelloBoard::OthelloBoard()
+{
+    // Standard Othello starting position
+    _discs[WHITE_PLAYER] = squareBit(3, 3) | squareBit(4, 4);
+    _discs[BLACK_PLAYER] = squareBit(4, 3) | squareBit(3, 4);
+}
+
+bool OthelloBoard::setStateString(const std::string &s)
+{
+    if (s.length() != SIZE * SIZE) return false;
+    for (char c : s) {
+        if (c != '0' && c != '1' && c != '2') return false;
+    }
+    _discs[0] = _discs[1] = 0;
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        if (s[i] != '0') {
+            _discs[s[i] - '1'] |= uint64_t(1) << i;
+        }
+    }
+    return true;
+}
+
+std::string OthelloBoard::stateString() const
+{
+    std::string state;
+    state.reserve(SIZE * SIZE);
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        state += (_discs[0] >> i) & 1 ? '1' : ((_discs[1] >> i) & 1 ? '2' : '0');
+    }
+    return state;
+}
+
+int OthelloBoard::cellOwner(int x, int y) const
+{
+    const uint64_t bit = squareBit(x, y);
+    if (_discs[BLACK_PLAYER] & bit) return BLACK_PLAYER;
+    if (_discs[WHITE_PLAYER] & bit) return WHITE_PLAYER;
+    return -1;
+}
+
+int OthelloBoard::countFlips(int x, int y, int player) const
+{
+    if (!isInside(x, y)) return 0;
+    return std::popcount(flips(square(x, y), player));
+}
+
+std::vector<std::pair<int, int>> OthelloBoard::getValidMoves(int player) const
+{
+    std::vector<std::pair<int, int>> moves;
+    for (uint64_t bits = legalMoves(player); bits; bits &= bits - 1) {
+        const int square = std::countr_zero(bits);
+        moves.push_back({square % SIZE, square / SIZE});
+    }
+    return moves;
+}
+
+bool OthelloBoard::play(int x, int y, int player)
+{
+    if (!isInside(x, y)) return false;
+    const uint64_t flipped = flips(square(x, y), player);
+    if (!flipped) return false;
+
+    play(square(x, y), flipped, player);
+    return true;
+}
+
+void OthelloBoard::flipPieces(int x, int y, int player)
+{
+    const uint64_t flipped = flips(square(x, y), player);
+    _discs[player] |= flipped;
+    _discs[1 - player] &= ~flipped;
+}
+
+void OthelloBoard::countPieces(int &blackCount, int &whiteCount) const
+{
+    blackCount = std::popcount(_discs[BLACK_PLAYER]);
+    whiteCount = std::popcount(_discs[WHITE_PLAYER]);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// Othello rules on two 64-bit bitboards, independent of the UI
+//
+// players are 0 (black, moves first) and 1 (white); the state string uses the
+// same row-major '0'/'1'/'2' format as Othello::stateString. square y * 8 + x is
+// bit y * 8 + x, so row 0 (the top row of the string) is the low byte.
+//
+// moves are generated for all 64 squares at once: for each of the 8 directions a
+// Kogge-Stone fill runs the player's discs through the adjacent opponent runs
+// in three shift steps (1, 2 and 4 squares), and the empty squares just beyond
+// those runs are the legal moves. the discs a move flips come from the same fill
+// started at the move, kept only where one of the mover's discs closes the run.
+//
+// the eight fills are independent, so on x86-64 they also run as SIMD kernels
+// (OthelloSimd.h). the best kernel the CPU supports is chosen at startup.
+//
+class OthelloBoard
+{
+public:
+    static const int SIZE = 8;
+    static const int BLACK_PLAYER = 0;
+    static const int WHITE_PLAYER = 1;
+
+    // standard starting position
+    OthelloBoard();
+
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+    static int  square(int x, int y) { return y * SIZE + x; }
+    static uint64_t squareBit(int x, int y) { return uint64_t(1) << square(x, y); }
+
+    // -1 for an empty square, otherwise the owning player
+    int         cellOwner(int x, int y) const;
+    bool        isInside(int x, int y) const { return x >= 0 && x < SIZE && y >= 0 && y < SIZE; }
+
+    uint64_t    discs(int player) const { return _discs[player]; }
+    uint64_t    emptySquares() const { return ~(_discs[0] | _discs[1]); }
+    // one bit per legal move of player
+    uint64_t    legalMoves(int player) const { return legalMoves(_discs[player], _discs[1 - player]); }
+    // the discs a move on square would flip, 0 if it is illegal
+    uint64_t    flips(int square, int player) const { return flips(_discs[player], _discs[1 - player], square); }
+
+    bool        isValidMove(int x, int y, int player) const { return isInside(x, y) && (legalMoves(player) & squareBit(x, y)); }
+    // discs a move at (x, y) would flip, 0 if it is illegal
+    int         countFlips(int x, int y, int player) const;
+    bool        hasValidMove(int player) const { return legalMoves(player) != 0; }
+    std::vector<std::pair<int, int>> getValidMoves(int player) const;
+
+    // place a disc for player and flip everything it captures; false if the move is illegal
+    bool        play(int x, int y, int player);
+    // place a disc on square with flips from flips(); no legality check
+    void        play(int square, uint64_t flipped, int player)
+    {
+        _discs[player] |= flipped | (uint64_t(1) << square);
+        _discs[1 - player] &= ~flipped;
+    }
+    // flip what a move at (x, y) captures, without placing its disc
+    void        flipPieces(int x, int y, int player);
+    void        countPieces(int &blackCount, int &whiteCount) const;
+    // neither side can move
+    bool        isGameOver() const { return !hasValidMove(BLACK_PLAYER) && !hasValidMove(WHITE_PLAYER); }
+
+    static uint64_t legalMoves(uint64_t own, uint64_t other) { return _legalMoves(own, other); }
+    static uint64_t flips(uint64_t own, uint64_t other, int square) { return _flips(own, other, square); }
+
+    // implementations of legalMoves and flips, for comparing them; all give the same results
+    enum Kernel {
+        KERNEL_SCALAR,
+        KERNEL_SSE2,    // every x86-64 CPU
+        KERNEL_AVX2,
+        KERNEL_COUNT
+    };
+    static Kernel kernel() { return _kernel; }
+    static const char *kernelName(Kernel kernel);
+    static bool kernelSupported(Kernel kernel);
+    // false, changing nothing, if the CPU lacks it. not thread-safe: switch before searching.
+    static bool setKernel(Kernel kernel);
+
+private:
+    static uint64_t (*_legalMoves)(uint64_t own, uint64_t other);
+    static uint64_t (*_flips)(uint64_t own, uint64_t other, int square);
+    static Kernel _kernel;
+
+    uint64_t    _discs[2];
+};
@@ -0,0 +1,97 @@
+#include "OthelloEvaluation.h"
+#include <array>
+
+namespace {
+const uint64_t NOT_A_FILE = 0xfefefefefefefefeULL;
+const uint64_t NOT_H_FILE = 0x7f7f7f7f7f7f7f7fULL;
+const uint64_t A_FILE = 0x0101010101010101ULL;
+const uint64_t H_FILE = 0x8080808080808080ULL;
+const uint64_t ROW_1 = 0x00000000000000ffULL;
+const uint64_t ROW_8 = 0xff00000000000000ULL;
+const uint64_t EDGES = A_FILE | H_FILE | ROW_1 | ROW_8;
+const uint64_t CORNERS = 0x8100000000000081ULL;
+
+// the squares of every diagonal, the 15 running down-right and then the 15 running down-left
+constexpr std::array<uint64_t, 30> diagonalMasks()
+{
+    std::array<uint64_t, 30> masks = {};
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            masks[x - y + 7] |= uint64_t(1) << (y * 8 + x);
+            masks[15 + x + y] |= uint64_t(1) << (y * 8 + x);
+        }
+    }
+    return masks;
+}
+constexpr std::array<uint64_t, 30> DIAGONALS = diagonalMasks();
+
+// the eight neighbours of every square in bits
+uint64_t neighbours(uint64_t bits)
+{
+    const uint64_t sideways = ((bits << 1) & NOT_A_FILE) | ((bits >> 1) & NOT_H_FILE) | bits;
+    return (sideways | (sideways << 8) | (sideways >> 8)) & ~bits;
+}
+
+// X-squares counted against their owner: b2, g2, b7 and g7, each only while its corner is empty
+uint64_t xSquares(uint64_t discs, uint64_t empty)
+{
+    const uint64_t emptyCorners = empty & CORNERS;
+    return discs & (((emptyCorners & NOT_H_FILE) << 9) | ((emptyCorners & NOT_A_FILE) << 7) |
+                    ((emptyCorners & NOT_A_FILE) >> 9) | ((emptyCorners & NOT_H_FILE) >> 7));
+}
+}
+
+uint64_t OthelloEvaluation::stableDiscs(uint64_t own, uint64_t other)
+{
+    // squares whose line in each direction is full; no move can ever be played on it
+    const uint64_t filled = own | other;
+    uint64_t fullRows = 0, fullColumns = 0, fullDiagonals = 0, fullAntiDiagonals = 0;
+    for (int i = 0; i < 8; i++) {
+        if (((filled >> (i * 8)) & 0xff) == 0xff) fullRows |= ROW_1 << (i * 8);
+        if (((filled >> i) & A_FILE) == A_FILE) fullColumns |= A_FILE << i;
+    }
+    for (int i = 0; i < 15; i++) {
+        if ((filled & DIAGONALS[i]) == DIAGONALS[i]) fullDiagonals |= DIAGONALS[i];
+        if ((filled & DIAGONALS[15 + i]) == DIAGONALS[15 + i]) fullAntiDiagonals |= DIAGONALS[15 + i];
+    }
+
+    // grow out from the edges: each pass adds the discs anchored on every line
+    uint64_t stable = 0;
+    for (;;) {
+        const uint64_t horizontal = fullRows | A_FILE | H_FILE | ((stable << 1) & NOT_A_FILE) | ((stable >> 1) & NOT_H_FILE);
+        const uint64_t vertical = fullColumns | ROW_1 | ROW_8 | (stable << 8) | (stable >> 8);
+        const uint64_t diagonal = fullDiagonals | EDGES | ((stable << 9) & NOT_A_FILE) | ((stable >> 9) & NOT_H_FILE);
+        const uint64_t antiDiagonal = fullAntiDiagonals | EDGES | ((stable << 7) & NOT_H_FILE) | ((stable >> 7) & NOT_A_FILE);
+        const uint64_t grown = own & horizontal & vertical & diagonal & antiDiagonal;
+        if (grown == stable) return stable;
+        stable = grown;
+    }
+}
+
+OthelloEvaluation::Terms OthelloEvaluation::terms(uint64_t own, uint64_t other)
+{
+    const uint64_t empty = ~(own | other);
+    Terms terms;
+    terms.mobility = std::popcount(OthelloBoard::legalMoves(own, other));
+    terms.frontier = std::popcount(own & neighbours(empty));
+    terms.corners = std::popcount(own & CORNERS);
+    terms.xSquares = std::popcount(xSquares(own, empty));
+    terms.stable = std::popcount(stableDiscs(own, other));
+    terms.discs = std::popcount(own);
+    return terms;
+}
+
+int OthelloEvaluation::evaluate(uint64_t own, uint64_t other)
+{
+    const Terms mine = terms(own, other);
+    const Terms theirs = terms(other, own);
+    int score = MOBILITY_WEIGHT * (mine.mobility - theirs.mobility) -
+                FRONTIER_WEIGHT * (mine.frontier - theirs.frontier) +
+                CORNER_WEIGHT * (mine.corners - theirs.corners) -
+                X_SQUARE_WEIGHT * (mine.xSquares - theirs.xSquares) +
+                STABLE_WEIGHT * (mine.stable - theirs.stable);
+    if (std::popcount(~(own | other)) <= MAX_EMPTIES_FOR_DISCS) {
+        score += DISC_WEIGHT * (mine.discs - theirs.discs);
+    }
+    return score;
+}
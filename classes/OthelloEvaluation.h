@@ -0,0 +1,51 @@
+#pragma once
+#include "OthelloBoard.h"
+
+//
+// static evaluation of an Othello position for the side to move
+//
+// own and other are the discs of the side to move and of its opponent. every
+// term is computed on the bitboards, as the side to move's count minus the
+// opponent's:
+//
+//  - mobility: legal moves
+//  - frontier: discs next to an empty square, which hand the opponent moves
+//    later; counted against the player who owns them
+//  - corners
+//  - X-squares: discs diagonally next to an empty corner, which give it away;
+//    counted against their owner
+//  - stable discs: discs that can never be flipped, found by growing out from
+//    the corners (see stableDiscs)
+//
+// in the last few moves mobility matters less than the discs themselves, so
+// the disc count is added once MAX_EMPTIES_FOR_DISCS or fewer squares are left.
+//
+class OthelloEvaluation
+{
+public:
+    static const int MOBILITY_WEIGHT = 8;
+    static const int FRONTIER_WEIGHT = 3;
+    static const int CORNER_WEIGHT = 40;
+    static const int X_SQUARE_WEIGHT = 20;
+    static const int STABLE_WEIGHT = 10;
+    static const int DISC_WEIGHT = 4;
+    static const int MAX_EMPTIES_FOR_DISCS = 10;
+
+    struct Terms {
+        int mobility;
+        int frontier;
+        int corners;
+        int xSquares;
+        int stable;
+        int discs;
+    };
+
+    static int  evaluate(uint64_t own, uint64_t other);
+    // one player's raw counts, for tuning and the tools
+    static Terms terms(uint64_t own, uint64_t other);
+
+    // discs of own that no sequence of moves can flip. conservative: a disc is
+    // stable when, along each of the four lines through it, the line is full or
+    // the disc touches the board edge or another stable disc of its colour.
+    static uint64_t stableDiscs(uint64_t own, uint64_t other);
+};
@@ -0,0 +1,228 @@
+#include "OthelloPatterns.h"
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'O', 'T', 'P', 'W'};
+const uint32_t VERSION = 1;
+
+struct Header
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t phaseCount;
+    uint32_t discsPerPhase;
+    uint32_t patternCount;
+    uint32_t weightsPerPhase;
+    uint32_t scale;
+    uint8_t  padding[36];
+};
+static_assert(sizeof(Header) == 64, "weights header must stay 64 bytes");
+
+struct Square
+{
+    int x, y;
+};
+
+// the squares of each pattern in one orientation, most significant digit first
+const std::vector<Square> &baseSquares(OthelloPatterns::Pattern pattern)
+{
+    static const std::vector<Square> SQUARES[OthelloPatterns::PATTERN_COUNT] = {
+        {},
+        {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {1, 1}, {6, 1}},
+        {{0, 0}, {1, 0}, {2, 0}, {0, 1}, {1, 1}, {2, 1}, {0, 2}, {1, 2}, {2, 2}},
+        {{0, 1}, {1, 1}, {2, 1}, {3, 1}, {4, 1}, {5, 1}, {6, 1}, {7, 1}},
+        {{0, 2}, {1, 2}, {2, 2}, {3, 2}, {4, 2}, {5, 2}, {6, 2}, {7, 2}},
+        {{0, 3}, {1, 3}, {2, 3}, {3, 3}, {4, 3}, {5, 3}, {6, 3}, {7, 3}},
+        {{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 5}, {6, 6}, {7, 7}},
+        {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 6}, {6, 7}},
+        {{0, 2}, {1, 3}, {2, 4}, {3, 5}, {4, 6}, {5, 7}},
+        {{0, 3}, {1, 4}, {2, 5}, {3, 6}, {4, 7}},
+        {{0, 4}, {1, 5}, {2, 6}, {3, 7}},
+    };
+    return SQUARES[pattern];
+}
+
+// the eight rotations and reflections of the board
+Square transform(Square s, int symmetry)
+{
+    if (symmetry & 4) s = {s.y, s.x};
+    if (symmetry & 1) s.x = 7 - s.x;
+    if (symmetry & 2) s.y = 7 - s.y;
+    return s;
+}
+
+std::vector<OthelloPatterns::Instance> buildInstances()
+{
+    std::vector<OthelloPatterns::Instance> instances;
+    for (int p = OthelloPatterns::PATTERN_EDGE_X; p < OthelloPatterns::PATTERN_COUNT; p++) {
+        const OthelloPatterns::Pattern pattern = (OthelloPatterns::Pattern)p;
+        const std::vector<Square> &base = baseSquares(pattern);
+        std::vector<uint64_t> seen;
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            OthelloPatterns::Instance instance;
+            instance.pattern = pattern;
+            instance.size = (int)base.size();
+            uint64_t mask = 0;
+            for (int i = 0; i < instance.size; i++) {
+                const Square s = transform(base[i], symmetry);
+                instance.squares[i] = (uint8_t)(s.y * 8 + s.x);
+                mask |= uint64_t(1) << instance.squares[i];
+            }
+            // symmetric patterns map onto themselves; each set of squares is read once
+            bool duplicate = false;
+            for (uint64_t other : seen) duplicate = duplicate || other == mask;
+            if (duplicate) continue;
+            seen.push_back(mask);
+            instances.push_back(instance);
+        }
+    }
+    return instances;
+}
+
+// the instances a square belongs to, with the base-3 digit it is in each
+struct SquareDigits
+{
+    int      count;
+    uint8_t  instance[OthelloPatterns::INSTANCE_COUNT];
+    uint16_t power[OthelloPatterns::INSTANCE_COUNT];
+};
+
+std::array<SquareDigits, 64> buildSquareDigits()
+{
+    std::array<SquareDigits, 64> squares = {};
+    const std::vector<OthelloPatterns::Instance> &instances = OthelloPatterns::instances();
+    for (int i = 0; i < (int)instances.size(); i++) {
+        int power = 1;
+        for (int j = instances[i].size - 1; j >= 0; j--, power *= 3) {
+            SquareDigits &digits = squares[instances[i].squares[j]];
+            digits.instance[digits.count] = (uint8_t)i;
+            digits.power[digits.count] = (uint16_t)power;
+            digits.count++;
+        }
+    }
+    return squares;
+}
+
+// walks the occupied squares once rather than every square of every instance
+void computeIndices(uint64_t own, uint64_t other, uint16_t out[OthelloPatterns::INSTANCE_COUNT])
+{
+    static const std::array<SquareDigits, 64> SQUARES = buildSquareDigits();
+    std::memset(out, 0, OthelloPatterns::INSTANCE_COUNT * sizeof(uint16_t));
+    for (; own; own &= own - 1) {
+        const SquareDigits &digits = SQUARES[std::countr_zero(own)];
+        for (int k = 0; k < digits.count; k++) out[digits.instance[k]] += digits.power[k];
+    }
+    for (; other; other &= other - 1) {
+        const SquareDigits &digits = SQUARES[std::countr_zero(other)];
+        for (int k = 0; k < digits.count; k++) out[digits.instance[k]] += 2 * digits.power[k];
+    }
+}
+
+}
+
+const std::vector<OthelloPatterns::Instance> &OthelloPatterns::instances()
+{
+    static const std::vector<Instance> INSTANCES = buildInstances();
+    return INSTANCES;
+}
+
+int OthelloPatterns::tableSize(Pattern pattern)
+{
+    int size = 1;
+    for (size_t i = 0; i < baseSquares(pattern).size(); i++) size *= 3;
+    return size;
+}
+
+int OthelloPatterns::tableOffset(Pattern pattern)
+{
+    int offset = 0;
+    for (int p = 0; p < pattern; p++) offset += tableSize((Pattern)p);
+    return offset;
+}
+
+int OthelloPatterns::weightsPerPhase()
+{
+    return tableOffset(PATTERN_COUNT);
+}
+
+void OthelloPatterns::indices(uint64_t own, uint64_t other, uint16_t out[INSTANCE_COUNT])
+{
+    computeIndices(own, other, out);
+}
+
+bool OthelloPatterns::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path))
+        return false;
+
+    Header header;
+    if (_file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.phaseCount != (uint32_t)PHASE_COUNT || header.discsPerPhase != (uint32_t)DISCS_PER_PHASE ||
+        header.patternCount != (uint32_t)PATTERN_COUNT || header.weightsPerPhase != (uint32_t)weightsPerPhase() ||
+        header.scale != (uint32_t)SCALE ||
+        _file.size() != sizeof(Header) + (size_t)PHASE_COUNT * weightsPerPhase() * sizeof(int16_t)) {
+        close();
+        return false;
+    }
+    _weights = reinterpret_cast<const int16_t *>(_file.data() + sizeof(Header));
+    return true;
+}
+
+void OthelloPatterns::close()
+{
+    _file.close();
+    _weights = nullptr;
+}
+
+int OthelloPatterns::evaluate(uint64_t own, uint64_t other) const
+{
+    static const int WEIGHTS_PER_PHASE = weightsPerPhase();
+    // where each instance's table starts in a phase
+    static const std::array<int, INSTANCE_COUNT> OFFSETS = [] {
+        std::array<int, INSTANCE_COUNT> offsets;
+        for (int i = 0; i < INSTANCE_COUNT; i++) offsets[i] = tableOffset(instances()[i].pattern);
+        return offsets;
+    }();
+
+    uint16_t index[INSTANCE_COUNT];
+    computeIndices(own, other, index);
+    const int16_t *weights = _weights + (size_t)phase(std::popcount(own | other)) * WEIGHTS_PER_PHASE;
+    int score = weights[tableOffset(PATTERN_BIAS)];
+    for (int i = 0; i < INSTANCE_COUNT; i++) {
+        score += weights[OFFSETS[i] + index[i]];
+    }
+    return score;
+}
+
+bool OthelloPatterns::write(const std::string &path, const std::vector<int16_t> &weights)
+{
+    if (weights.size() != (size_t)PHASE_COUNT * weightsPerPhase())
+        return false;
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.phaseCount = PHASE_COUNT;
+    header.discsPerPhase = DISCS_PER_PHASE;
+    header.patternCount = PATTERN_COUNT;
+    header.weightsPerPhase = (uint32_t)weightsPerPhase();
+    header.scale = SCALE;
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    const bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                    std::fwrite(weights.data(), sizeof(int16_t), weights.size(), file) == weights.size();
+    return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// pattern-table evaluation of an Othello position, with weights memory-mapped
+// from a file written by otrain
+//
+// a pattern is a fixed list of squares: an edge with its two X-squares, a 3x3
+// corner, the second, third and fourth rows and the diagonals of length 4 to
+// 8. each appears on the board once per distinct rotation or reflection, 38
+// instances in all, and every instance of a pattern reads the same table. an
+// instance's contents make a base-3 index (0 empty, 1 the side to move's disc,
+// 2 the opponent's) into that table, so an evaluation is one table lookup per
+// instance plus a bias for the side to move.
+//
+// the weights are fitted to final disc differences and stored as 16-bit
+// integers in 1/SCALE discs. there is one full set per game phase, picked by
+// the number of discs on the board, because a pattern is worth very different
+// amounts in the opening and the endgame.
+//
+// the file is a 64-byte header followed by the phases in order, each holding
+// the tables of every pattern back to back, little-endian like the other data
+// files. with no file open evaluate() must not be called; the search falls
+// back to OthelloEvaluation.
+//
+class OthelloPatterns
+{
+public:
+    enum Pattern {
+        PATTERN_BIAS,           // no squares: one weight per phase
+        PATTERN_EDGE_X,
+        PATTERN_CORNER_3X3,
+        PATTERN_ROW_2,
+        PATTERN_ROW_3,
+        PATTERN_ROW_4,
+        PATTERN_DIAGONAL_8,
+        PATTERN_DIAGONAL_7,
+        PATTERN_DIAGONAL_6,
+        PATTERN_DIAGONAL_5,
+        PATTERN_DIAGONAL_4,
+        PATTERN_COUNT
+    };
+
+    static const int INSTANCE_COUNT = 38;
+    static const int MAX_PATTERN_SQUARES = 10;
+    static const int DISCS_PER_PHASE = 5;
+    // 4 to 63 discs; a full board never needs evaluating
+    static const int PHASE_COUNT = 12;
+    static const int SCALE = 64;
+
+    struct Instance {
+        Pattern pattern;
+        int     size;
+        uint8_t squares[MAX_PATTERN_SQUARES];  // most significant base-3 digit first
+    };
+
+    OthelloPatterns() : _weights(nullptr) {}
+
+    // map a weights file; false (and no weights) if it is missing or does not match these patterns
+    bool        open(const std::string &path);
+    void        close();
+    bool        isOpen() const { return _weights != nullptr; }
+
+    // in 1/SCALE discs from the side to move's (own) point of view
+    int         evaluate(uint64_t own, uint64_t other) const;
+
+    static int  phase(int discs)
+    {
+        const int phase = (discs - 4) / DISCS_PER_PHASE;
+        return phase < 0 ? 0 : (phase >= PHASE_COUNT ? PHASE_COUNT - 1 : phase);
+    }
+    static const std::vector<Instance> &instances();
+    // entries in one pattern's table, 3 to the number of its squares
+    static int  tableSize(Pattern pattern);
+    // where a pattern's table starts in a phase
+    static int  tableOffset(Pattern pattern);
+    static int  weightsPerPhase();
+    // the table index of every instance for the position, in instances() order
+    static void indices(uint64_t own, uint64_t other, uint16_t out[INSTANCE_COUNT]);
+
+    // write a weights file; weights holds PHASE_COUNT * weightsPerPhase() values, phase by phase
+    static bool write(const std::string &path, const std::vector<int16_t> &weights);
+
+private:
+    MappedFile  _file;
+    const int16_t *_weights;
+};
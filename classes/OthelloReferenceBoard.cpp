@@ -0,0 +1,155 @@
+#include "OthelloReferenceBoard.h"
+
+// Define the 8 directions: N, NE, E, SE, S, SW, W, NW
+const int OthelloReferenceBoard::DIRECTIONS[8][2] = {
+    {0, -1}, {1, -1}, {1, 0}, {1, 1},
+    {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+};
+
+OthelloReferenceBoard::OthelloReferenceBoard()
+{
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        _cells[i] = -1;
+    }
+    // Standard Othello starting position
+    _cells[3 * SIZE + 3] = WHITE_PLAYER;
+    _cells[4 * SIZE + 4] = WHITE_PLAYER;
+    _cells[3 * SIZE + 4] = BLACK_PLAYER;
+    _cells[4 * SIZE + 3] = BLACK_PLAYER;
+}
+
+bool OthelloReferenceBoard::setStateString(const std::string &s)
+{
+    if (s.length() != SIZE * SIZE) return false;
+    for (char c : s) {
+        if (c != '0' && c != '1' && c != '2') return false;
+    }
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        _cells[i] = (int8_t)(s[i] - '1');
+    }
+    return true;
+}
+
+std::string OthelloReferenceBoard::stateString() const
+{
+    std::string state;
+    state.reserve(SIZE * SIZE);
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        state += (char)('1' + _cells[i]);
+    }
+    return state;
+}
+
+bool OthelloReferenceBoard::isValidMove(int x, int y, int player) const
+{
+    if (!isInside(x, y) || cellOwner(x, y) >= 0) return false;
+
+    // Check if placing a piece here would flip at least one opponent piece
+    for (int i = 0; i < 8; i++) {
+        if (checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int OthelloReferenceBoard::checkDirection(int x, int y, int dx, int dy, int player) const
+{
+    int count = 0;
+    int nx = x + dx;
+    int ny = y + dy;
+
+    if (!isInside(nx, ny)) return 0;
+
+    const int first = cellOwner(nx, ny);
+    if (first < 0 || first == player) return 0;
+
+    // Count opponent pieces in this direction
+    while (isInside(nx, ny)) {
+        const int owner = cellOwner(nx, ny);
+        if (owner < 0) return 0;
+        if (owner == player) return count;
+        count++;
+        nx += dx;
+        ny += dy;
+    }
+    return 0;
+}
+
+int OthelloReferenceBoard::countFlips(int x, int y, int player) const
+{
+    if (!isInside(x, y) || cellOwner(x, y) >= 0) return 0;
+
+    int total = 0;
+    for (int i = 0; i < 8; i++) {
+        total += checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
+    }
+    return total;
+}
+
+bool OthelloReferenceBoard::hasValidMove(int player) const
+{
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (isValidMove(x, y, player)) return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::pair<int, int>> OthelloReferenceBoard::getValidMoves(int player) const
+{
+    std::vector<std::pair<int, int>> moves;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (isValidMove(x, y, player)) {
+                moves.push_back({x, y});
+            }
+        }
+    }
+    return moves;
+}
+
+bool OthelloReferenceBoard::play(int x, int y, int player)
+{
+    if (!isValidMove(x, y, player)) return false;
+
+    flipPieces(x, y, player);
+    _cells[y * SIZE + x] = (int8_t)player;
+    return true;
+}
+
+void OthelloReferenceBoard::flipPieces(int x, int y, int player)
+{
+    for (int i = 0; i < 8; i++) {
+        int count = checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
+        if (count > 0) {
+            flipInDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player, count);
+        }
+    }
+}
+
+void OthelloReferenceBoard::flipInDirection(int x, int y, int dx, int dy, int player, int count)
+{
+    int nx = x + dx;
+    int ny = y + dy;
+
+    for (int i = 0; i < count; i++) {
+        _cells[ny * SIZE + nx] = (int8_t)player;
+        nx += dx;
+        ny += dy;
+    }
+}
+
+void OthelloReferenceBoard::countPieces(int &blackCount, int &whiteCount) const
+{
+    blackCount = 0;
+    whiteCount = 0;
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        if (_cells[i] == BLACK_PLAYER) {
+            blackCount++;
+        } else if (_cells[i] == WHITE_PLAYER) {
+            whiteCount++;
+        }
+    }
+}
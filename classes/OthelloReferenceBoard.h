@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// the original Othello rules on a plain 8x8 array, walking each direction square
+// by square. OthelloBoard replaced it with bitboards; it stays as the simple
+// implementation that perft (othello:reference) and the benchmarks compare against.
+//
+// same interface, players and state strings as OthelloBoard.
+//
+class OthelloReferenceBoard
+{
+public:
+    static const int SIZE = 8;
+    static const int BLACK_PLAYER = 0;
+    static const int WHITE_PLAYER = 1;
+
+    // Direction vectors for checking all 8 directions
+    static const int DIRECTIONS[8][2];
+
+    // standard starting position
+    OthelloReferenceBoard();
+
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+    // -1 for an empty square, otherwise the owning player
+    int         cellOwner(int x, int y) const { return _cells[y * SIZE + x]; }
+    bool        isInside(int x, int y) const { return x >= 0 && x < SIZE && y >= 0 && y < SIZE; }
+
+    bool        isValidMove(int x, int y, int player) const;
+    int         checkDirection(int x, int y, int dx, int dy, int player) const;
+    // discs a move at (x, y) would flip, 0 if it is illegal
+    int         countFlips(int x, int y, int player) const;
+    bool        hasValidMove(int player) const;
+    std::vector<std::pair<int, int>> getValidMoves(int player) const;
+
+    // place a disc for player and flip everything it captures; false if the move is illegal
+    bool        play(int x, int y, int player);
+    void        flipPieces(int x, int y, int player);
+    void        countPieces(int &blackCount, int &whiteCount) const;
+    // neither side can move
+    bool        isGameOver() const { return !hasValidMove(BLACK_PLAYER) && !hasValidMove(WHITE_PLAYER); }
+
+private:
+    void        flipInDirection(int x, int y, int dx, int dy, int player, int count);
+
+    int8_t      _cells[SIZE * SIZE];
+};
@@ -0,0 +1,290 @@
+#include "OthelloSearch.h"
+#include "OthelloEvaluation.h"
+#include <algorithm>
+
+namespace {
+// how often (in nodes) the search looks at the clock and the cancel flag
+const uint64_t STOP_CHECK_INTERVAL = 1024;
+
+// sort keys for the move ordering
+const int PV_BONUS = 1 << 24;
+const int TABLE_MOVE_BONUS = 1 << 23;
+const int CORNER_BONUS = 1 << 16;
+const int X_SQUARE_PENALTY = 1 << 12;
+const int MOBILITY_KEY_WEIGHT = 64;
+// below this remaining depth the squares alone order the moves; counting the
+// opponent's replies to every move costs more than it saves near the leaves
+const int MIN_DEPTH_FOR_MOBILITY_ORDERING = 3;
+
+const uint64_t CORNERS = 0x8100000000000081ULL;
+const uint64_t X_SQUARES = 0x0042000000004200ULL;
+}
+
+OthelloSearch::OthelloSearch(size_t tableMegabytes)
+    : _table(tableMegabytes), _tableMegabytes(tableMegabytes), _patterns(nullptr), _cancel(nullptr), _stop(false), _hasDeadline(false)
+{
+}
+
+void OthelloSearch::newGame()
+{
+    _table.clear();
+    if (_solver) {
+        _solver->clear();
+    }
+}
+
+uint64_t OthelloSearch::hash(uint64_t own, uint64_t other)
+{
+    // mix both boards into every bit; the table takes its index from the low bits and its key from the high ones
+    uint64_t h = own * 0x9e3779b97f4a7c15ULL;
+    h ^= std::rotl(other * 0xc2b2ae3d27d4eb4fULL, 31);
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+OthelloSearchResult OthelloSearch::search(const OthelloBoard &board, int player, const OthelloSearchLimits &limits,
+                                          const std::atomic<bool> *cancel)
+{
+    const auto start = std::chrono::steady_clock::now();
+    OthelloSearchResult result;
+    _cancel = cancel;
+    _hasDeadline = limits.timeBudgetMs > 0;
+    _deadline = start + std::chrono::milliseconds(limits.timeBudgetMs);
+    _stop = false;
+    _stats = SearchStats();
+    _stats.plies.assign(MAX_PLY, PlyStats());
+    _previousPV.clear();
+    _table.newSearch();
+
+    const uint64_t own = board.discs(player);
+    const uint64_t other = board.discs(1 - player);
+    const uint64_t moves = OthelloBoard::legalMoves(own, other);
+    if (!moves) {
+        return result;
+    }
+    // always have something legal to play, even if the first iteration is cut short
+    result.move = std::countr_zero(moves);
+
+    const int empties = std::popcount(board.emptySquares());
+    if (empties <= limits.solveEmpties) {
+        if (!_solver) {
+            _solver = std::make_unique<OthelloSolver>(_tableMegabytes);
+        }
+        const OthelloSolveResult solved = _solver->bestMove(board, player, cancel);
+        result.move = solved.move;
+        if (!_solver->stopped()) {
+            result.score = exactScore(solved.score);
+            result.exact = true;
+            result.depth = empties;
+            result.pv.assign(1, solved.move);
+        }
+        // the solver keeps no table or per-ply counters of its own
+        result.stats.nodes = solved.nodes;
+        result.stats.depth = result.depth;
+        result.stats.timeMs = solved.timeMs;
+        return result;
+    }
+
+    // with passes not counted, a search as deep as the empty squares reaches the end of every line
+    const int maxDepth = limits.maxDepth > 0 ? std::min(limits.maxDepth, empties) : empties;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        const int score = searchRoot(own, other, depth);
+        if (_stop) {
+            break;
+        }
+        _previousPV.assign(_pv[0], _pv[0] + _pvLength[0]);
+        result.score = score;
+        result.depth = depth;
+        result.pv = _previousPV;
+        if (!result.pv.empty()) {
+            result.move = result.pv[0];
+        }
+        // a game end found before then is only as good as the evaluation of the
+        // lines that were cut short, so it does not stop the deepening
+        result.exact = depth == empties;
+    }
+
+    SearchStats &stats = result.stats;
+    stats = _stats;
+    stats.depth = result.depth;
+    while (!stats.plies.empty() && stats.plies.back().nodes == 0) {
+        stats.plies.pop_back();
+    }
+    for (const PlyStats &ply : stats.plies) {
+        stats.cutoffs += ply.cutoffs;
+        stats.firstMoveCutoffs += ply.firstMoveCutoffs;
+    }
+    _table.recordProbes(stats.tableProbes, stats.tableHits);
+    stats.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int OthelloSearch::searchRoot(uint64_t own, uint64_t other, int depth)
+{
+    return negamax(own, other, depth, 0, -SCORE_INFINITY, SCORE_INFINITY, true, false);
+}
+
+bool OthelloSearch::shouldStop()
+{
+    if (_stop) {
+        return true;
+    }
+    if ((_stats.nodes % STOP_CHECK_INTERVAL) != 0) {
+        return false;
+    }
+    if ((_cancel && _cancel->load(std::memory_order_relaxed)) ||
+        (_hasDeadline && std::chrono::steady_clock::now() >= _deadline)) {
+        _stop = true;
+    }
+    return _stop;
+}
+
+int OthelloSearch::orderMoves(uint64_t own, uint64_t other, uint64_t moves, int depth, int pvMove, int tableMove, int order[]) const
+{
+    int keys[64];
+    int count = 0;
+    for (uint64_t bits = moves; bits; bits &= bits - 1) {
+        const int square = std::countr_zero(bits);
+        const uint64_t bit = bits & -bits;
+        int key = 0;
+        if (square == pvMove) {
+            key += PV_BONUS;
+        }
+        if (square == tableMove) {
+            key += TABLE_MOVE_BONUS;
+        }
+        if (bit & CORNERS) {
+            key += CORNER_BONUS;
+        }
+        if (bit & X_SQUARES) {
+            key -= X_SQUARE_PENALTY;
+        }
+        // fastest first: the fewer replies a move leaves, the smaller the subtree behind it
+        if (depth >= MIN_DEPTH_FOR_MOBILITY_ORDERING) {
+            const uint64_t flipped = OthelloBoard::flips(own, other, square);
+            key -= MOBILITY_KEY_WEIGHT * std::popcount(OthelloBoard::legalMoves(other & ~flipped, own | flipped | bit));
+        }
+
+        // insertion sort; ties keep the square order
+        int j = count++;
+        while (j > 0 && keys[j - 1] < key) {
+            keys[j] = keys[j - 1];
+            order[j] = order[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        order[j] = square;
+    }
+    return count;
+}
+
+int OthelloSearch::negamax(uint64_t own, uint64_t other, int depth, int ply, int alpha, int beta, bool onPV, bool passed)
+{
+    _stats.nodes++;
+    _stats.plies[ply].nodes++;
+    _pvLength[ply] = 0;
+    if (shouldStop()) {
+        return 0;
+    }
+
+    const uint64_t moves = OthelloBoard::legalMoves(own, other);
+    if (!moves) {
+        // two passes in a row end the game
+        if (passed) {
+            return finalScore(own, other);
+        }
+        const int score = -negamax(other, own, depth, ply + 1, -beta, -alpha, onPV, true);
+        _pv[ply][0] = PASS;
+        std::copy(_pv[ply + 1], _pv[ply + 1] + _pvLength[ply + 1], _pv[ply] + 1);
+        _pvLength[ply] = _pvLength[ply + 1] + 1;
+        return score;
+    }
+    if (depth == 0) {
+        const int score = _patterns ? _patterns->evaluate(own, other) : OthelloEvaluation::evaluate(own, other);
+        return std::clamp(score, -WIN_SCORE / 2 + 1, WIN_SCORE / 2 - 1);
+    }
+
+    // final scores depend only on the discs, so entries can be reused whatever
+    // move order reached the position. the root is never cut off here so the
+    // iteration always produces a move and a PV.
+    const uint64_t key = hash(own, other);
+    const int alphaOrig = alpha;
+    int tableMove = -1;
+    TranspositionTable::Entry entry;
+    _stats.tableProbes++;
+    if (_table.probe(key, entry)) {
+        _stats.tableHits++;
+        tableMove = entry.move;
+        if (ply > 0 && entry.depth >= depth) {
+            if (entry.bound == TranspositionTable::BOUND_EXACT) {
+                return entry.score;
+            }
+            if (entry.bound == TranspositionTable::BOUND_LOWER) {
+                alpha = std::max(alpha, entry.score);
+            } else if (entry.bound == TranspositionTable::BOUND_UPPER) {
+                beta = std::min(beta, entry.score);
+            }
+            if (alpha >= beta) {
+                return entry.score;
+            }
+        }
+    }
+
+    const int pvMove = onPV && ply < (int)_previousPV.size() ? _previousPV[ply] : -1;
+    int order[64];
+    const int count = orderMoves(own, other, moves, depth, pvMove, tableMove, order);
+
+    int best = -SCORE_INFINITY;
+    int bestMove = -1;
+    for (int i = 0; i < count; i++) {
+        const int square = order[i];
+        const uint64_t flipped = OthelloBoard::flips(own, other, square);
+        const uint64_t nextOwn = other & ~flipped;
+        const uint64_t nextOther = own | flipped | (uint64_t(1) << square);
+
+        // only the first move gets the full window; the rest are asked whether they
+        // beat alpha and searched again for an exact score only when they do
+        int score;
+        if (i == 0) {
+            score = -negamax(nextOwn, nextOther, depth - 1, ply + 1, -beta, -alpha, square == pvMove, false);
+        } else {
+            score = -negamax(nextOwn, nextOther, depth - 1, ply + 1, -alpha - 1, -alpha, false, false);
+            if (score > alpha && score < beta && !_stop) {
+                _stats.pvsResearches++;
+                score = -negamax(nextOwn, nextOther, depth - 1, ply + 1, -beta, -alpha, false, false);
+            }
+        }
+        if (_stop) {
+            return 0;
+        }
+
+        if (score > best) {
+            best = score;
+            bestMove = square;
+        }
+        if (score > alpha) {
+            alpha = score;
+            _pv[ply][0] = square;
+            std::copy(_pv[ply + 1], _pv[ply + 1] + _pvLength[ply + 1], _pv[ply] + 1);
+            _pvLength[ply] = _pvLength[ply + 1] + 1;
+        }
+        if (alpha >= beta) {
+            _stats.plies[ply].cutoffs++;
+            if (i == 0) {
+                _stats.plies[ply].firstMoveCutoffs++;
+            }
+            break; // alpha-beta cutoff
+        }
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+    if (best <= alphaOrig) {
+        bound = TranspositionTable::BOUND_UPPER;
+    } else if (best >= beta) {
+        bound = TranspositionTable::BOUND_LOWER;
+    }
+    _table.store(key, best, depth, bound, bestMove);
+    return best;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "OthelloBoard.h"
+#include "OthelloPatterns.h"
+#include "OthelloSolver.h"
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct OthelloSearchLimits
+{
+    int maxDepth = 0;       // plies, not counting passes; 0 searches to the end of the game
+    int timeBudgetMs = 0;   // wall-clock budget; 0 means no time limit
+    // with this many empty squares or fewer the exact solver plays instead, ignoring the limits above; 0 never solves
+    int solveEmpties = 0;
+};
+
+struct OthelloSearchResult
+{
+    int move = -1;          // square y * 8 + x; -1 when the side to move has to pass or the game is over
+    int score = 0;          // from the side to move's point of view
+    int depth = 0;          // last completed iteration
+    // score is the final disc difference with perfect play: it came from the solver
+    // or from an iteration as deep as the empty squares, which reaches the end of every line
+    bool exact = false;
+    std::vector<int> pv;    // principal variation of that iteration; PASS for a pass
+    SearchStats stats;
+};
+
+//
+// iterative-deepening principal variation search over an Othello board
+//
+// positions are searched as (own, other) disc pairs for the side to move, so the
+// same arrangement of discs is one table entry whichever colour is to move. a
+// pass does not use up depth, and a game that ends inside the search is scored
+// exactly, above every evaluation, by its final disc difference. such a score
+// at the root is still only proven once an iteration is as deep as the empty
+// squares; until then a side can be steered into a worse ending that the
+// evaluated lines hide, so deepening goes on.
+//
+// moves are tried in the order: previous iteration's PV move, table move, then
+// corners first, X-squares last and, away from the leaves, the moves that leave
+// the opponent the fewest replies first.
+//
+// the transposition table lives as long as the search object, so a game that
+// keeps one OthelloSearch around reuses the tree from its previous moves. so
+// does the OthelloSolver it hands the last few moves to, created on first use
+// with a table of the same size.
+//
+class OthelloSearch
+{
+public:
+    static const int PASS = 64;
+    static const int WIN_SCORE = 10000;
+    static const int SCORE_INFINITY = 30000;
+    // each real move can be followed by at most one pass
+    static const int MAX_PLY = 2 * OthelloBoard::SIZE * OthelloBoard::SIZE;
+
+    explicit OthelloSearch(size_t tableMegabytes = 16);
+
+    // deepen one ply at a time until the limits run out, returning the last
+    // completed iteration. setting cancel stops the search as if time ran out.
+    OthelloSearchResult search(const OthelloBoard &board, int player, const OthelloSearchLimits &limits,
+                               const std::atomic<bool> *cancel = nullptr);
+    // forget everything learned from the previous game
+    void        newGame();
+    // pattern weights to evaluate leaves with instead of OthelloEvaluation; they must
+    // outlive the search. nullptr, or weights that are not open, go back to it.
+    void        setPatterns(const OthelloPatterns *patterns) { _patterns = patterns && patterns->isOpen() ? patterns : nullptr; }
+
+    // a finished game, scored by its disc difference with the empty squares going to the winner
+    static int  finalScore(uint64_t own, uint64_t other) { return exactScore(OthelloSolver::finalScore(own, other)); }
+    // the score of a proven final disc difference
+    static int  exactScore(int discDifference) { return discDifference > 0 ? WIN_SCORE + discDifference : (discDifference < 0 ? -WIN_SCORE + discDifference : 0); }
+    static bool isFinalScore(int score) { return score >= WIN_SCORE / 2 || score <= -WIN_SCORE / 2; }
+    // the disc difference a final score stands for
+    static int  discDifference(int score) { return score > 0 ? score - WIN_SCORE : (score < 0 ? score + WIN_SCORE : 0); }
+
+    static uint64_t hash(uint64_t own, uint64_t other);
+
+    TranspositionTable &table() { return _table; }
+    const TranspositionTable &table() const { return _table; }
+
+private:
+    int         searchRoot(uint64_t own, uint64_t other, int depth);
+    int         negamax(uint64_t own, uint64_t other, int depth, int ply, int alpha, int beta, bool onPV, bool passed);
+    int         orderMoves(uint64_t own, uint64_t other, uint64_t moves, int depth, int pvMove, int tableMove, int order[]) const;
+    bool        shouldStop();
+
+    TranspositionTable _table;
+    size_t      _tableMegabytes;
+    std::unique_ptr<OthelloSolver> _solver;
+    const OthelloPatterns *_patterns;
+    const std::atomic<bool> *_cancel;
+    bool        _stop;
+    std::chrono::steady_clock::time_point _deadline;
+    bool        _hasDeadline;
+
+    SearchStats _stats;
+    // triangular principal-variation table for the running iteration and the
+    // line from the previous one that is searched first
+    int         _pv[MAX_PLY][MAX_PLY];
+    int         _pvLength[MAX_PLY];
+    std::vector<int> _previousPV;
+};
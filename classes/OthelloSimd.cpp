@@ -0,0 +1,244 @@
+#include "OthelloSimd.h"
+
+#ifdef OTHELLO_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// the AVX2 functions are compiled for AVX2 on their own, so the rest of the program
+// still runs on any x86-64 CPU; MSVC allows the intrinsics without a flag
+#if defined(__GNUC__) || defined(__clang__)
+#define OTHELLO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define OTHELLO_TARGET_AVX2
+#endif
+
+namespace {
+const uint64_t NOT_A_FILE = 0xfefefefefefefefeULL;
+const uint64_t NOT_H_FILE = 0x7f7f7f7f7f7f7f7fULL;
+
+uint64_t byteSwap(uint64_t b)
+{
+#ifdef _MSC_VER
+    return _byteswap_uint64(b);
+#else
+    return __builtin_bswap64(b);
+#endif
+}
+
+//
+// scalar east and west, which the SSE2 lanes cannot mirror
+//
+uint64_t horizontalMoves(uint64_t own, uint64_t other, uint64_t empty)
+{
+    uint64_t pro = other & NOT_A_FILE;
+    uint64_t east = own;
+    east |= pro & (east << 1);
+    uint64_t pro2 = pro & (pro << 1);
+    east |= pro2 & (east << 2);
+    east |= (pro2 & (pro2 << 2)) & (east << 4);
+
+    pro = other & NOT_H_FILE;
+    uint64_t west = own;
+    west |= pro & (west >> 1);
+    pro2 = pro & (pro >> 1);
+    west |= pro2 & (west >> 2);
+    west |= (pro2 & (pro2 >> 2)) & (west >> 4);
+
+    return (((east & other) << 1) & NOT_A_FILE & empty) | (((west & other) >> 1) & NOT_H_FILE & empty);
+}
+
+uint64_t horizontalFlips(uint64_t own, uint64_t other, uint64_t move)
+{
+    uint64_t pro = other & NOT_A_FILE;
+    uint64_t east = move;
+    east |= pro & (east << 1);
+    uint64_t pro2 = pro & (pro << 1);
+    east |= pro2 & (east << 2);
+    east |= (pro2 & (pro2 << 2)) & (east << 4);
+
+    pro = other & NOT_H_FILE;
+    uint64_t west = move;
+    west |= pro & (west >> 1);
+    pro2 = pro & (pro >> 1);
+    west |= pro2 & (west >> 2);
+    west |= (pro2 & (pro2 >> 2)) & (west >> 4);
+
+    uint64_t flipped = 0;
+    if ((east << 1) & NOT_A_FILE & own) flipped |= east & other;
+    if ((west >> 1) & NOT_H_FILE & own) flipped |= west & other;
+    return flipped;
+}
+
+//
+// SSE2: lane 0 is the board, lane 1 the board upside down
+//
+template <int Shift>
+__m128i fillSSE2(__m128i gen, __m128i pro)
+{
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_slli_epi64(gen, Shift)));
+    pro = _mm_and_si128(pro, _mm_slli_epi64(pro, Shift));
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_slli_epi64(gen, 2 * Shift)));
+    pro = _mm_and_si128(pro, _mm_slli_epi64(pro, 2 * Shift));
+    return _mm_or_si128(gen, _mm_and_si128(pro, _mm_slli_epi64(gen, 4 * Shift)));
+}
+
+// south / north (8), south-east / north-east (9) and south-west / north-west (7)
+template <int Shift>
+__m128i movesPairSSE2(__m128i own, __m128i other, __m128i mask)
+{
+    const __m128i gen = fillSSE2<Shift>(own, _mm_and_si128(other, mask));
+    return _mm_and_si128(_mm_slli_epi64(_mm_and_si128(gen, other), Shift), mask);
+}
+
+template <int Shift>
+__m128i flipsPairSSE2(__m128i own, __m128i other, __m128i move, __m128i mask)
+{
+    const __m128i run = fillSSE2<Shift>(move, _mm_and_si128(other, mask));
+    const __m128i closed = _mm_and_si128(_mm_and_si128(_mm_slli_epi64(run, Shift), mask), own);
+    // SSE2 has no 64-bit compare: a lane is zero when both of its 32-bit halves are
+    const __m128i zero32 = _mm_cmpeq_epi32(closed, _mm_setzero_si128());
+    const __m128i open = _mm_and_si128(zero32, _mm_shuffle_epi32(zero32, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_andnot_si128(open, _mm_and_si128(run, other));
+}
+
+uint64_t combineSSE2(__m128i lanes)
+{
+    const uint64_t board = (uint64_t)_mm_cvtsi128_si64(lanes);
+    const uint64_t flipped = (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(lanes, lanes));
+    return board | byteSwap(flipped);
+}
+
+//
+// AVX2: lanes are east, south, south-east, south-west for left shifts and the
+// opposite directions for right shifts
+//
+OTHELLO_TARGET_AVX2 __m256i shifts()
+{
+    return _mm256_set_epi64x(7, 9, 8, 1);
+}
+
+OTHELLO_TARGET_AVX2 __m256i leftMasks()
+{
+    return _mm256_set_epi64x((long long)NOT_H_FILE, (long long)NOT_A_FILE, -1LL, (long long)NOT_A_FILE);
+}
+
+OTHELLO_TARGET_AVX2 __m256i rightMasks()
+{
+    return _mm256_set_epi64x((long long)NOT_A_FILE, (long long)NOT_H_FILE, -1LL, (long long)NOT_H_FILE);
+}
+
+OTHELLO_TARGET_AVX2 __m256i fillLeft(__m256i gen, __m256i pro, __m256i shift)
+{
+    const __m256i shift2 = _mm256_add_epi64(shift, shift);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, shift));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift2)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, shift2));
+    return _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, _mm256_add_epi64(shift2, shift2))));
+}
+
+OTHELLO_TARGET_AVX2 __m256i fillRight(__m256i gen, __m256i pro, __m256i shift)
+{
+    const __m256i shift2 = _mm256_add_epi64(shift, shift);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, shift));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift2)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, shift2));
+    return _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, _mm256_add_epi64(shift2, shift2))));
+}
+
+OTHELLO_TARGET_AVX2 uint64_t orLanes(__m256i lanes)
+{
+    __m128i half = _mm_or_si128(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+    half = _mm_or_si128(half, _mm_unpackhi_epi64(half, half));
+    return (uint64_t)_mm_cvtsi128_si64(half);
+}
+}
+
+namespace OthelloSimd {
+
+bool cpuHasAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    // the OS must save the YMM registers on a context switch
+    const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+uint64_t legalMovesSSE2(uint64_t own, uint64_t other)
+{
+    const __m128i ownLanes = _mm_set_epi64x((long long)byteSwap(own), (long long)own);
+    const __m128i otherLanes = _mm_set_epi64x((long long)byteSwap(other), (long long)other);
+    const __m128i moves = _mm_or_si128(
+        _mm_or_si128(movesPairSSE2<8>(ownLanes, otherLanes, _mm_set1_epi64x(-1LL)),
+                     movesPairSSE2<9>(ownLanes, otherLanes, _mm_set1_epi64x((long long)NOT_A_FILE))),
+        movesPairSSE2<7>(ownLanes, otherLanes, _mm_set1_epi64x((long long)NOT_H_FILE)));
+    const uint64_t empty = ~(own | other);
+    return (combineSSE2(moves) & empty) | horizontalMoves(own, other, empty);
+}
+
+uint64_t flipsSSE2(uint64_t own, uint64_t other, int square)
+{
+    const uint64_t move = uint64_t(1) << square;
+    if ((own | other) & move) return 0;
+
+    const __m128i ownLanes = _mm_set_epi64x((long long)byteSwap(own), (long long)own);
+    const __m128i otherLanes = _mm_set_epi64x((long long)byteSwap(other), (long long)other);
+    const __m128i moveLanes = _mm_set_epi64x((long long)byteSwap(move), (long long)move);
+    const __m128i flipped = _mm_or_si128(
+        _mm_or_si128(flipsPairSSE2<8>(ownLanes, otherLanes, moveLanes, _mm_set1_epi64x(-1LL)),
+                     flipsPairSSE2<9>(ownLanes, otherLanes, moveLanes, _mm_set1_epi64x((long long)NOT_A_FILE))),
+        flipsPairSSE2<7>(ownLanes, otherLanes, moveLanes, _mm_set1_epi64x((long long)NOT_H_FILE)));
+    return combineSSE2(flipped) | horizontalFlips(own, other, move);
+}
+
+OTHELLO_TARGET_AVX2 uint64_t legalMovesAVX2(uint64_t own, uint64_t other)
+{
+    const __m256i ownLanes = _mm256_set1_epi64x((long long)own);
+    const __m256i otherLanes = _mm256_set1_epi64x((long long)other);
+    const __m256i shift = shifts();
+    const __m256i left = leftMasks(), right = rightMasks();
+
+    const __m256i genLeft = fillLeft(ownLanes, _mm256_and_si256(otherLanes, left), shift);
+    const __m256i genRight = fillRight(ownLanes, _mm256_and_si256(otherLanes, right), shift);
+    const __m256i moves = _mm256_or_si256(
+        _mm256_and_si256(_mm256_sllv_epi64(_mm256_and_si256(genLeft, otherLanes), shift), left),
+        _mm256_and_si256(_mm256_srlv_epi64(_mm256_and_si256(genRight, otherLanes), shift), right));
+    return orLanes(moves) & ~(own | other);
+}
+
+OTHELLO_TARGET_AVX2 uint64_t flipsAVX2(uint64_t own, uint64_t other, int square)
+{
+    const uint64_t move = uint64_t(1) << square;
+    if ((own | other) & move) return 0;
+
+    const __m256i ownLanes = _mm256_set1_epi64x((long long)own);
+    const __m256i otherLanes = _mm256_set1_epi64x((long long)other);
+    const __m256i moveLanes = _mm256_set1_epi64x((long long)move);
+    const __m256i shift = shifts();
+    const __m256i left = leftMasks(), right = rightMasks();
+    const __m256i zero = _mm256_setzero_si256();
+
+    // a run is kept only in the lanes where one of the mover's discs closes it
+    const __m256i runLeft = fillLeft(moveLanes, _mm256_and_si256(otherLanes, left), shift);
+    const __m256i closedLeft = _mm256_and_si256(_mm256_and_si256(_mm256_sllv_epi64(runLeft, shift), left), ownLanes);
+    const __m256i runRight = fillRight(moveLanes, _mm256_and_si256(otherLanes, right), shift);
+    const __m256i closedRight = _mm256_and_si256(_mm256_and_si256(_mm256_srlv_epi64(runRight, shift), right), ownLanes);
+    const __m256i flipped = _mm256_or_si256(
+        _mm256_andnot_si256(_mm256_cmpeq_epi64(closedLeft, zero), _mm256_and_si256(runLeft, otherLanes)),
+        _mm256_andnot_si256(_mm256_cmpeq_epi64(closedRight, zero), _mm256_and_si256(runRight, otherLanes)));
+    return orLanes(flipped);
+}
+
+}
+#endif
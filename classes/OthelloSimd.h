@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+//
+// SSE2 and AVX2 versions of OthelloBoard::legalMoves and OthelloBoard::flips
+//
+// OthelloBoard picks one of these at startup from what the CPU supports; nothing
+// else should call them directly. AVX2 runs four directions per 256-bit register
+// (east, south, south-east, south-west, then the four opposite ones) with
+// per-lane shift counts. SSE2 has no per-lane counts, so its two lanes hold the
+// board and its byte-swapped (upside-down) copy: one left shift then covers a
+// direction and its vertical mirror, and only east/west stay scalar.
+//
+#if defined(__x86_64__) || defined(_M_X64)
+#define OTHELLO_SIMD_X86 1
+
+namespace OthelloSimd {
+bool        cpuHasAVX2();
+
+uint64_t    legalMovesSSE2(uint64_t own, uint64_t other);
+uint64_t    flipsSSE2(uint64_t own, uint64_t other, int square);
+uint64_t    legalMovesAVX2(uint64_t own, uint64_t other);
+uint64_t    flipsAVX2(uint64_t own, uint64_t other, int square);
+}
+#endif
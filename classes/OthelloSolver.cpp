@@ -0,0 +1,333 @@
+#include "OthelloSolver.h"
+#include "OthelloEvaluation.h"
+#include "OthelloSearch.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// how often (in nodes) the solver looks at the cancel flag
+const uint64_t STOP_CHECK_INTERVAL = 4096;
+
+const int TABLE_MOVE_BONUS = 1 << 24;
+const int CORNER_BONUS = 1 << 4;
+const int PARITY_BONUS = 1 << 2;
+const int MOBILITY_KEY_WEIGHT = 1 << 8;
+
+const uint64_t CORNERS = 0x8100000000000081ULL;
+const uint64_t QUADRANTS[4] = {0x000000000f0f0f0fULL, 0x00000000f0f0f0f0ULL, 0x0f0f0f0f00000000ULL, 0xf0f0f0f000000000ULL};
+
+// the empty squares of every quadrant holding an odd number of them
+uint64_t oddQuadrants(uint64_t empty)
+{
+    uint64_t odd = 0;
+    for (uint64_t quadrant : QUADRANTS) {
+        if (std::popcount(empty & quadrant) & 1) odd |= quadrant;
+    }
+    return odd & empty;
+}
+}
+
+OthelloSolver::OthelloSolver(size_t tableMegabytes)
+    : _table(tableMegabytes, TranspositionTable::KEY_FULL), _cancel(nullptr), _stopped(false), _nodes(0), _nextStopCheck(0)
+{
+}
+
+int OthelloSolver::finalScore(uint64_t own, uint64_t other)
+{
+    const int ownDiscs = std::popcount(own);
+    const int otherDiscs = std::popcount(other);
+    const int empty = MAX_SCORE - ownDiscs - otherDiscs;
+    if (ownDiscs > otherDiscs) return ownDiscs - otherDiscs + empty;
+    if (ownDiscs < otherDiscs) return ownDiscs - otherDiscs - empty;
+    return 0;
+}
+
+int OthelloSolver::solve(uint64_t own, uint64_t other, const std::atomic<bool> *cancel)
+{
+    _cancel = cancel;
+    _stopped = false;
+    _nextStopCheck = _nodes + STOP_CHECK_INTERVAL;
+    _table.newSearch();
+    const int score = negamax(own, other, -MAX_SCORE, MAX_SCORE, false);
+    return _stopped ? 0 : score;
+}
+
+OthelloSolveResult OthelloSolver::bestMove(const OthelloBoard &board, int player, const std::atomic<bool> *cancel)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startNodes = _nodes;
+    const uint64_t own = board.discs(player);
+    const uint64_t other = board.discs(1 - player);
+    OthelloSolveResult result;
+
+    const uint64_t moves = OthelloBoard::legalMoves(own, other);
+    if (!moves) {
+        result.score = solve(own, other, cancel);
+    } else {
+        _cancel = cancel;
+        _stopped = false;
+        _nextStopCheck = _nodes + STOP_CHECK_INTERVAL;
+        _table.newSearch();
+        _nodes++;
+
+        int order[64];
+        const int count = orderMoves(own, other, moves, -1, order);
+        int alpha = -MAX_SCORE - 1;
+        for (int i = 0; i < count && !_stopped; i++) {
+            const int square = order[i];
+            const uint64_t flipped = OthelloBoard::flips(own, other, square);
+            const uint64_t nextOwn = other & ~flipped;
+            const uint64_t nextOther = own | flipped | (uint64_t(1) << square);
+            // the first move sets the bar; the rest are only searched exactly if a null window says they beat it
+            int score;
+            if (i == 0) {
+                score = -negamax(nextOwn, nextOther, -MAX_SCORE, MAX_SCORE, false);
+            } else {
+                score = -negamax(nextOwn, nextOther, -alpha - 1, -alpha, false);
+                if (score > alpha && !_stopped) {
+                    score = -negamax(nextOwn, nextOther, -MAX_SCORE, -alpha, false);
+                }
+            }
+            if (!_stopped && score > alpha) {
+                alpha = score;
+                result.move = square;
+                result.score = score;
+            }
+        }
+        if (result.move < 0) {
+            result.move = order[0];
+        }
+    }
+    result.nodes = _nodes - startNodes;
+    result.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool OthelloSolver::shouldStop()
+{
+    if (_stopped) {
+        return true;
+    }
+    if (_nodes < _nextStopCheck) {
+        return false;
+    }
+    _nextStopCheck = _nodes + STOP_CHECK_INTERVAL;
+    _stopped = _cancel && _cancel->load(std::memory_order_relaxed);
+    return _stopped;
+}
+
+int OthelloSolver::orderMoves(uint64_t own, uint64_t other, uint64_t moves, int tableMove, int order[]) const
+{
+    const uint64_t empty = ~(own | other);
+    const uint64_t odd = oddQuadrants(empty);
+    const bool fastestFirst = std::popcount(empty) >= FASTEST_FIRST_MIN_EMPTIES;
+    int keys[64];
+    int count = 0;
+    for (uint64_t bits = moves; bits; bits &= bits - 1) {
+        const int square = std::countr_zero(bits);
+        const uint64_t bit = bits & -bits;
+        int key = 0;
+        if (square == tableMove) {
+            key += TABLE_MOVE_BONUS;
+        }
+        if (bit & odd) {
+            key += PARITY_BONUS;
+        }
+        if (fastestFirst) {
+            if (bit & CORNERS) {
+                key += CORNER_BONUS;
+            }
+            const uint64_t flipped = OthelloBoard::flips(own, other, square);
+            // replies on a corner count twice
+            const uint64_t replies = OthelloBoard::legalMoves(other & ~flipped, own | flipped | bit);
+            key -= MOBILITY_KEY_WEIGHT * (std::popcount(replies) + std::popcount(replies & CORNERS));
+        }
+
+        // insertion sort; ties keep the square order
+        int j = count++;
+        while (j > 0 && keys[j - 1] < key) {
+            keys[j] = keys[j - 1];
+            order[j] = order[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        order[j] = square;
+    }
+    return count;
+}
+
+int OthelloSolver::negamax(uint64_t own, uint64_t other, int alpha, int beta, bool passed)
+{
+    const uint64_t empty = ~(own | other);
+    const int empties = std::popcount(empty);
+    if (empties <= 4) {
+        // odd quadrants first, decided once for the last few moves
+        int squares[4];
+        int count = 0;
+        const uint64_t odd = oddQuadrants(empty);
+        for (uint64_t bits : {odd, empty & ~odd}) {
+            for (; bits; bits &= bits - 1) {
+                squares[count++] = std::countr_zero(bits);
+            }
+        }
+        switch (empties) {
+        case 4: return solveLast<4>(own, other, alpha, beta, squares, passed);
+        case 3: return solveLast<3>(own, other, alpha, beta, squares, passed);
+        case 2: return solveLast<2>(own, other, alpha, beta, squares, passed);
+        case 1: return solveLast<1>(own, other, alpha, beta, squares, passed);
+        default:
+            _nodes++;
+            return finalScore(own, other);
+        }
+    }
+
+    _nodes++;
+    if (shouldStop()) {
+        return 0;
+    }
+
+    const uint64_t moves = OthelloBoard::legalMoves(own, other);
+    if (!moves) {
+        // two passes in a row end the game
+        if (passed) {
+            return finalScore(own, other);
+        }
+        return -negamax(other, own, -beta, -alpha, true);
+    }
+
+    // the opponent's stable discs are theirs at the end whatever happens
+    if (empties >= STABILITY_MIN_EMPTIES) {
+        const int bound = MAX_SCORE - 2 * std::popcount(OthelloEvaluation::stableDiscs(other, own));
+        if (bound <= alpha) {
+            return bound;
+        }
+        beta = std::min(beta, bound);
+    }
+
+    const bool useTable = empties >= TABLE_MIN_EMPTIES;
+    const uint64_t key = useTable ? OthelloSearch::hash(own, other) : 0;
+    const int alphaOrig = alpha;
+    int tableMove = -1;
+    if (useTable) {
+        TranspositionTable::Entry entry;
+        if (_table.probe(key, entry) && entry.depth == empties) {
+            tableMove = entry.move;
+            if (entry.bound == TranspositionTable::BOUND_EXACT) {
+                return entry.score;
+            }
+            if (entry.bound == TranspositionTable::BOUND_LOWER) {
+                alpha = std::max(alpha, entry.score);
+            } else if (entry.bound == TranspositionTable::BOUND_UPPER) {
+                beta = std::min(beta, entry.score);
+            }
+            if (alpha >= beta) {
+                return entry.score;
+            }
+        }
+    }
+
+    int order[64];
+    const int count = orderMoves(own, other, moves, tableMove, order);
+    int best = -MAX_SCORE - 1;
+    int bestMove = -1;
+    for (int i = 0; i < count; i++) {
+        const int square = order[i];
+        const uint64_t flipped = OthelloBoard::flips(own, other, square);
+        const uint64_t nextOwn = other & ~flipped;
+        const uint64_t nextOther = own | flipped | (uint64_t(1) << square);
+
+        int score;
+        if (i == 0) {
+            score = -negamax(nextOwn, nextOther, -beta, -alpha, false);
+        } else {
+            score = -negamax(nextOwn, nextOther, -alpha - 1, -alpha, false);
+            if (score > alpha && score < beta && !_stopped) {
+                score = -negamax(nextOwn, nextOther, -beta, -alpha, false);
+            }
+        }
+        if (_stopped) {
+            return 0;
+        }
+
+        if (score > best) {
+            best = score;
+            bestMove = square;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    if (useTable) {
+        TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+        if (best <= alphaOrig) {
+            bound = TranspositionTable::BOUND_UPPER;
+        } else if (best >= beta) {
+            bound = TranspositionTable::BOUND_LOWER;
+        }
+        _table.store(key, best, empties, bound, bestMove);
+    }
+    return best;
+}
+
+template <int N>
+int OthelloSolver::solveLast(uint64_t own, uint64_t other, int alpha, int beta, const int *squares, bool passed)
+{
+    if constexpr (N == 1) {
+        return solveLast1(own, other, squares[0]);
+    } else {
+        _nodes++;
+        int best = -MAX_SCORE - 1;
+        for (int i = 0; i < N; i++) {
+            const int square = squares[i];
+            const uint64_t flipped = OthelloBoard::flips(own, other, square);
+            if (!flipped) {
+                continue;
+            }
+            // the other squares, still in parity order
+            int rest[N - 1];
+            for (int j = 0, k = 0; j < N; j++) {
+                if (j != i) rest[k++] = squares[j];
+            }
+            const int score = -solveLast<N - 1>(other & ~flipped, own | flipped | (uint64_t(1) << square), -beta, -alpha, rest, false);
+            if (score > best) {
+                best = score;
+                if (score > alpha) {
+                    alpha = score;
+                    if (alpha >= beta) {
+                        return best;
+                    }
+                }
+            }
+        }
+        if (best > -MAX_SCORE - 1) {
+            return best;
+        }
+        // no move here: pass, or the game ends with these squares still empty
+        if (passed) {
+            return finalScore(own, other);
+        }
+        return -solveLast<N>(other, own, -beta, -alpha, squares, true);
+    }
+}
+
+int OthelloSolver::solveLast1(uint64_t own, uint64_t other, int square)
+{
+    // 63 discs on the board, so counting own's is enough
+    _nodes++;
+    const int ownDiscs = std::popcount(own);
+    uint64_t flipped = OthelloBoard::flips(own, other, square);
+    if (flipped) {
+        return 2 * (ownDiscs + std::popcount(flipped) + 1) - MAX_SCORE;
+    }
+    flipped = OthelloBoard::flips(other, own, square);
+    if (flipped) {
+        return 2 * (ownDiscs - std::popcount(flipped)) - MAX_SCORE;
+    }
+    // nobody can fill the last square; it goes to the winner, and with 63 discs there is one
+    const int difference = 2 * ownDiscs - (MAX_SCORE - 1);
+    return difference > 0 ? difference + 1 : difference - 1;
+}
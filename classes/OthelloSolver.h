@@ -0,0 +1,75 @@
+#pragma once
+#include "OthelloBoard.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+
+struct OthelloSolveResult
+{
+    // exact final disc difference for the side to move with perfect play from both
+    // sides, the empty squares of a finished game going to the winner
+    int score = 0;
+    int move = -1;              // a best square; -1 when the side to move has to pass or the game is over
+    uint64_t nodes = 0;
+    double timeMs = 0.0;
+};
+
+//
+// exact Othello endgame solver
+//
+// unlike OthelloSearch there is no evaluation: every line is played to the end
+// and scored by its final disc difference. the order moves are tried in
+// changes with the number of empty squares left:
+//
+//  - from FASTEST_FIRST_MIN_EMPTIES up: the table move, then the moves that
+//    leave the opponent the fewest replies (fastest first), corners breaking ties
+//  - below that: parity, moves in a quadrant with an odd number of empty squares
+//    first, so the side to move tends to get the last move in each region
+//  - the last four empties are solved by unrolled routines that try the empty
+//    squares directly instead of generating moves, ordered by parity once
+//
+// bounds go into a transposition table from TABLE_MIN_EMPTIES up, kept between
+// calls so solving the positions of one game gets faster as it goes. entries
+// are checked against the whole 64-bit hash (KEY_FULL), so a bound is never
+// taken from another position short of a full hash collision. a side
+// whose stable discs already rule out beating alpha is cut off without a search.
+//
+class OthelloSolver
+{
+public:
+    static const int MAX_SCORE = OthelloBoard::SIZE * OthelloBoard::SIZE;
+    static const int FASTEST_FIRST_MIN_EMPTIES = 7;
+    static const int TABLE_MIN_EMPTIES = 8;
+    static const int STABILITY_MIN_EMPTIES = 9;
+
+    explicit OthelloSolver(size_t tableMegabytes = 64);
+
+    // exact score of the position for the side to move (own); setting cancel abandons the solve and returns 0
+    int         solve(uint64_t own, uint64_t other, const std::atomic<bool> *cancel = nullptr);
+    // exact score and a best move for player
+    OthelloSolveResult bestMove(const OthelloBoard &board, int player, const std::atomic<bool> *cancel = nullptr);
+
+    // the final disc difference of a finished game, the empty squares going to the winner
+    static int  finalScore(uint64_t own, uint64_t other);
+
+    bool        stopped() const { return _stopped; }
+    uint64_t    nodes() const { return _nodes; }
+    void        clear() { _table.clear(); }
+
+    TranspositionTable &table() { return _table; }
+
+private:
+    int         negamax(uint64_t own, uint64_t other, int alpha, int beta, bool passed);
+    // the last N empty squares, listed in the order to try them
+    template <int N>
+    int         solveLast(uint64_t own, uint64_t other, int alpha, int beta, const int *squares, bool passed);
+    int         solveLast1(uint64_t own, uint64_t other, int square);
+    int         orderMoves(uint64_t own, uint64_t other, uint64_t moves, int tableMove, int order[]) const;
+    bool        shouldStop();
+
+    TranspositionTable _table;
+    const std::atomic<bool> *_cancel;
+    bool        _stopped;
+    uint64_t    _nodes;
+    uint64_t    _nextStopCheck;
+};
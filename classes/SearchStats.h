@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// how well move ordering worked at one distance from the root
+struct PlyStats
+{
+    uint64_t nodes = 0;
+    uint64_t cutoffs = 0;           // beta cutoffs
+    uint64_t firstMoveCutoffs = 0;  // cutoffs produced by the first move searched
+};
+
+//
+// cost of one AI search, filled in by the engines and shown by the tools and UI
+//
+struct SearchStats
+{
+    uint64_t nodes = 0;         // summed over all search threads
+    int     depth = 0;          // deepest completed iteration
+    int     threads = 1;
+    double  timeMs = 0.0;
+    uint64_t tableProbes = 0;
+    uint64_t tableHits = 0;
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;
+    // re-searches, for tuning the windows: a null-window probe that beat alpha, and a root
+    // aspiration window the score fell below or rose above
+    uint64_t pvsResearches = 0;
+    uint64_t aspirationFailLows = 0;
+    uint64_t aspirationFailHighs = 0;
+    uint64_t endgameHits = 0;   // positions answered exactly by an endgame database
+    std::vector<PlyStats> plies;    // indexed by ply from the root
+
+    double  nodesPerSecond() const { return timeMs > 0.0 ? (double)nodes * 1000.0 / timeMs : 0.0; }
+    double  tableHitRate() const { return tableProbes ? (double)tableHits / (double)tableProbes : 0.0; }
+    // fraction of cutoffs found on the first move; 1.0 means perfect ordering
+    double  firstMoveCutoffRate() const { return cutoffs ? (double)firstMoveCutoffs / (double)cutoffs : 0.0; }
+};
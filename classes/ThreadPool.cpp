@@ -0,0 +1,118 @@
+#include "ThreadPool.h"
+
+namespace {
+thread_local ThreadPool *currentPool = nullptr;
+thread_local int currentWorker = -1;
+}
+
+ThreadPool::ThreadPool(int threads)
+    : _pending(0), _nextWorker(0), _stopping(false)
+{
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // start the threads only once every deque exists, since they steal from each other
+    for (int i = 0; i < threads; i++) {
+        _workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto &worker : _workers) {
+        worker->thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    const int target = currentPool == this ? currentWorker
+                                           : (int)(_nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size());
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> guard(_workers[target]->lock);
+        _workers[target]->tasks.push_back(std::move(task));
+    }
+    // taking _lock orders the push before a sleeping worker's re-check
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+    }
+    _wake.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    _idle.wait(guard, [this] { return _pending.load() == 0; });
+}
+
+int ThreadPool::workerIndex()
+{
+    return currentWorker;
+}
+
+bool ThreadPool::takeTask(int index, Task &task)
+{
+    // own work first, newest first
+    {
+        Worker &own = *_workers[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    // then the oldest task of the next worker that has any
+    const int count = (int)_workers.size();
+    for (int i = 1; i < count; i++) {
+        Worker &victim = *_workers[(index + i) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    Task task;
+    for (;;) {
+        if (takeTask(index, task)) {
+            task();
+            task = nullptr;
+            if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> guard(_lock);
+                _idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(_lock);
+        if (_stopping)
+            return;
+        // every queue was empty a moment ago; sleep unless something arrived since
+        bool queued = false;
+        for (auto &worker : _workers) {
+            std::lock_guard<std::mutex> workerGuard(worker->lock);
+            queued = queued || !worker->tasks.empty();
+        }
+        if (!queued)
+            _wake.wait(guard);
+    }
+}
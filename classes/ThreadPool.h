@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// fixed set of worker threads running independent tasks, for batch tools
+//
+// every worker owns a deque. a task submitted from a worker goes to the back of
+// its own deque and the owner takes work from the back too, so recently split
+// work stays hot in its cache; an idle worker steals from the front of another
+// worker's deque. tasks submitted from outside are dealt round-robin.
+//
+// the deques are short and their locks are held only to push or pop one task,
+// which is cheap next to a task that runs a search.
+//
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // 0 threads uses every hardware thread
+    explicit ThreadPool(int threads = 0);
+    // runs what is still queued, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int         threadCount() const { return (int)_workers.size(); }
+    void        submit(Task task);
+    // block until every submitted task has finished
+    void        wait();
+
+    // index of the pool worker running the caller, -1 outside a pool; lets tasks
+    // pick per-thread state such as a search object
+    static int  workerIndex();
+
+private:
+    struct Worker {
+        std::mutex  lock;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void        run(int index);
+    bool        takeTask(int index, Task &task);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::mutex  _lock;                  // guards the two condition variables below
+    std::condition_variable _wake;      // a task was queued or the pool is stopping
+    std::condition_variable _idle;      // the last pending task finished
+    std::atomic<int> _pending;          // submitted but not yet finished
+    std::atomic<unsigned> _nextWorker;  // round-robin target for outside submissions
+    bool        _stopping;
+};
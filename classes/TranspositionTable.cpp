@@ -0,0 +1,147 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+namespace {
+// entry layout, high to low: key (29) | generation (3) | score (16) | depth (7) | bound (2) | move + 1 (7)
+const int KEY_SHIFT = 35;
+const int GENERATION_SHIFT = 32;
+const int SCORE_SHIFT = 16;
+const int DEPTH_SHIFT = 9;
+const int BOUND_SHIFT = 7;
+
+uint64_t entryKey(uint64_t hash)
+{
+    return hash >> KEY_SHIFT;
+}
+
+uint64_t packEntry(uint64_t hash, unsigned generation, int score, int depth, TranspositionTable::Bound bound, int move)
+{
+    return (entryKey(hash) << KEY_SHIFT) |
+           ((uint64_t)generation << GENERATION_SHIFT) |
+           ((uint64_t)(uint16_t)(int16_t)score << SCORE_SHIFT) |
+           ((uint64_t)depth << DEPTH_SHIFT) |
+           ((uint64_t)bound << BOUND_SHIFT) |
+           (uint64_t)(move + 1);
+}
+
+int entryDepth(uint64_t data)
+{
+    return (int)((data >> DEPTH_SHIFT) & 0x7f);
+}
+
+unsigned entryGeneration(uint64_t data)
+{
+    return (unsigned)((data >> GENERATION_SHIFT) & 0x7);
+}
+
+TranspositionTable::Bound entryBound(uint64_t data)
+{
+    return (TranspositionTable::Bound)((data >> BOUND_SHIFT) & 0x3);
+}
+
+int entryMove(uint64_t data)
+{
+    return (int)(data & 0x7f) - 1;
+}
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes, KeyCheck keyCheck)
+    : _clusterCount(0), _keyCheck(keyCheck), _generation(0), _probes(0), _hits(0)
+{
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+    _clusterCount = std::max<size_t>(1, (megabytes * 1024 * 1024) / sizeof(Cluster));
+    _clusters = std::make_unique<Cluster[]>(_clusterCount);
+    _generation = 0;
+    resetStats();
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < _clusterCount; i++) {
+        for (std::atomic<uint64_t> &entry : _clusters[i].entries) {
+            entry.store(0, std::memory_order_relaxed);
+        }
+    }
+    _generation = 0;
+    resetStats();
+}
+
+uint64_t TranspositionTable::slotData(const Cluster &cluster, int slot) const
+{
+    return cluster.entries[_keyCheck == KEY_FULL ? 2 * slot + 1 : slot].load(std::memory_order_relaxed);
+}
+
+bool TranspositionTable::slotMatches(const Cluster &cluster, int slot, uint64_t data, uint64_t hash) const
+{
+    if (_keyCheck == KEY_FULL) {
+        return (cluster.entries[2 * slot].load(std::memory_order_relaxed) ^ data) == hash;
+    }
+    return (data >> KEY_SHIFT) == entryKey(hash);
+}
+
+void TranspositionTable::writeSlot(Cluster &cluster, int slot, uint64_t data, uint64_t hash)
+{
+    if (_keyCheck == KEY_FULL) {
+        cluster.entries[2 * slot].store(hash ^ data, std::memory_order_relaxed);
+        cluster.entries[2 * slot + 1].store(data, std::memory_order_relaxed);
+    } else {
+        cluster.entries[slot].store(data, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(uint64_t hash, Entry &entry) const
+{
+    const Cluster &cluster = clusterFor(hash);
+    const int slots = slotsPerCluster();
+    for (int i = 0; i < slots; i++) {
+        const uint64_t data = slotData(cluster, i);
+        if (entryBound(data) == BOUND_NONE || !slotMatches(cluster, i, data, hash)) {
+            continue;
+        }
+        entry.score = (int16_t)(uint16_t)(data >> SCORE_SHIFT);
+        entry.depth = entryDepth(data);
+        entry.bound = entryBound(data);
+        entry.move = entryMove(data);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t hash, int score, int depth, Bound bound, int move)
+{
+    Cluster &cluster = clusterFor(hash);
+    const int slots = slotsPerCluster();
+    depth = std::clamp(depth, 0, MAX_DEPTH);
+    move = std::clamp(move, -1, MAX_MOVE);
+
+    // replace the same position if present, else an empty slot, else the
+    // entry with the lowest depth once stale generations are penalised
+    int victim = 0;
+    int victimWorth = 1 << 30;
+    for (int i = 0; i < slots; i++) {
+        const uint64_t data = slotData(cluster, i);
+        if (entryBound(data) == BOUND_NONE) {
+            victim = i;
+            break;
+        }
+        if (slotMatches(cluster, i, data, hash)) {
+            // keep a known best move when the new result didn't produce one
+            if (move < 0) {
+                move = entryMove(data);
+            }
+            victim = i;
+            break;
+        }
+        const int age = (int)((_generation - entryGeneration(data)) & GENERATION_MASK);
+        const int worth = entryDepth(data) - 8 * age;
+        if (worth < victimWorth) {
+            victimWorth = worth;
+            victim = i;
+        }
+    }
+    writeSlot(cluster, victim, packEntry(hash, _generation, score, depth, bound, move), hash);
+}
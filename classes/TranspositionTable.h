@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+//
+// fixed-size transposition table shared by the game-tree searches
+//
+// every entry is packed into a single 64-bit word and eight of them share a
+// 64-byte cluster, so a probe touches exactly one cache line. the table size
+// is set from a memory budget in megabytes and rounded down to whole clusters.
+//
+// entries are read and written with relaxed atomics, so several search threads
+// can share one table without locks: a racing store may replace an entry, but a
+// probe never sees half of one.
+//
+// a packed entry keeps only 29 bits of the hash, and the cluster index covers
+// about log2(clusters) more, so a long search expects the odd false match. that
+// costs a heuristic search little, but an exact solver would report the bound
+// of an unrelated position as a proven score. KEY_FULL tables store the whole
+// 64-bit hash beside each entry instead, four entries to a cluster: a slot
+// holds hash ^ data and data, so a slot torn by a racing store fails the key
+// check rather than matching. a false match then needs two positions with the
+// same 64-bit hash.
+//
+class TranspositionTable
+{
+public:
+    enum Bound {
+        BOUND_NONE = 0,
+        BOUND_EXACT,
+        BOUND_LOWER,    // score is a lower bound (fail high)
+        BOUND_UPPER     // score is an upper bound (fail low)
+    };
+
+    struct Entry {
+        int     score;
+        int     depth;
+        Bound   bound;
+        int     move;   // -1 when no best move is known
+    };
+
+    enum KeyCheck {
+        KEY_PACKED,     // 29 key bits inside the entry; eight entries per cluster
+        KEY_FULL        // the whole hash checked; four entries per cluster
+    };
+
+    static const int MAX_DEPTH = 127;
+    static const int MAX_MOVE = 126;
+
+    explicit TranspositionTable(size_t megabytes = 16, KeyCheck keyCheck = KEY_PACKED);
+
+    void        resize(size_t megabytes);
+    void        clear();
+    // start a new search; older entries become preferred replacement victims
+    void        newSearch() { _generation = (_generation + 1) & GENERATION_MASK; }
+
+    bool        probe(uint64_t hash, Entry &entry) const;
+    void        store(uint64_t hash, int score, int depth, Bound bound, int move);
+
+    size_t      sizeInBytes() const { return _clusterCount * sizeof(Cluster); }
+    size_t      capacity() const { return _clusterCount * slotsPerCluster(); }
+
+    // searches count their own probes per thread and report them here once done
+    void        recordProbes(uint64_t probes, uint64_t hits) { _probes += probes; _hits += hits; }
+    uint64_t    probes() const { return _probes; }
+    uint64_t    hits() const { return _hits; }
+    double      hitRate() const { return _probes ? (double)_hits / (double)_probes : 0.0; }
+    void        resetStats() { _probes = 0; _hits = 0; }
+
+private:
+    static const int CLUSTER_SIZE = 8;
+    static const unsigned GENERATION_MASK = 7;
+
+    struct alignas(64) Cluster {
+        std::atomic<uint64_t> entries[CLUSTER_SIZE];
+    };
+
+    Cluster &   clusterFor(uint64_t hash) const { return _clusters[((hash & 0xffffffffu) * _clusterCount) >> 32]; }
+    int         slotsPerCluster() const { return _keyCheck == KEY_FULL ? CLUSTER_SIZE / 2 : CLUSTER_SIZE; }
+    uint64_t    slotData(const Cluster &cluster, int slot) const;
+    bool        slotMatches(const Cluster &cluster, int slot, uint64_t data, uint64_t hash) const;
+    void        writeSlot(Cluster &cluster, int slot, uint64_t data, uint64_t hash);
+
+    std::unique_ptr<Cluster[]> _clusters;
+    size_t      _clusterCount;
+    KeyCheck    _keyCheck;
+    unsigned    _generation;
+    std::atomic<uint64_t> _probes;
+    std::atomic<uint64_t> _hits;
+};
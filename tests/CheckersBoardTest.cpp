@@ -0,0 +1,71 @@
+#include "CheckersBoard.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//
+// CheckersBoardTest: the move rules the Checkers game leans on, on hand-built positions
+//
+//   CheckersBoardTest
+//
+// a jump sequence in progress may only be continued by the piece that jumped, and
+// only by jumping again, even when another piece of the same side could jump. a
+// side whose only moves are captures still has a move, so it has not lost.
+//
+namespace {
+
+struct Piece
+{
+    int x, y, piece;
+};
+
+// a board holding only the given pieces
+CheckersBoard boardWith(const std::vector<Piece> &pieces)
+{
+    std::string state(32, '0');
+    for (const Piece &piece : pieces) {
+        // the 32 playable squares, row-major: four per row
+        state[piece.y * 4 + piece.x / 2] = (char)('0' + piece.piece);
+    }
+    CheckersBoard board;
+    board.setStateString(state);
+    return board;
+}
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        std::printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+}
+
+int main()
+{
+    // red has just jumped to (3, 4) and can jump again over (4, 5); the red piece
+    // on (5, 2) has a jump of its own over (6, 3)
+    const CheckersBoard midJump = boardWith({{3, 4, CheckersBoard::RED_PIECE}, {4, 5, CheckersBoard::YELLOW_PIECE},
+                                             {5, 2, CheckersBoard::RED_PIECE}, {6, 3, CheckersBoard::YELLOW_PIECE}});
+    check(midJump.canMoveFromTo(5, 2, 7, 4), "the other red piece has a jump outside a sequence");
+    check(midJump.canContinueJump(3, 4, 3, 4, 5, 6), "the jumping piece continues its sequence");
+    check(!midJump.canContinueJump(3, 4, 5, 2, 7, 4), "another piece jumps in the middle of a sequence");
+    check(!midJump.canContinueJump(3, 4, 3, 4, 2, 5), "the jumping piece makes a simple step mid-sequence");
+
+    // red's only piece is hemmed in, but can capture (2, 1)
+    const CheckersBoard onlyJump = boardWith({{1, 0, CheckersBoard::RED_PIECE}, {0, 1, CheckersBoard::YELLOW_PIECE},
+                                              {2, 1, CheckersBoard::YELLOW_PIECE}});
+    check(onlyJump.canMoveFromTo(1, 0, 3, 2), "the capture is legal");
+    check(onlyJump.hasAnyMove(CheckersBoard::RED_PLAYER), "a side with only a capture has a move");
+
+    // and with the landing square taken it has none
+    const CheckersBoard blocked = boardWith({{1, 0, CheckersBoard::RED_PIECE}, {0, 1, CheckersBoard::YELLOW_PIECE},
+                                             {2, 1, CheckersBoard::YELLOW_PIECE}, {3, 2, CheckersBoard::YELLOW_PIECE}});
+    check(!blocked.hasAnyMove(CheckersBoard::RED_PLAYER), "a side with no step and no capture has no move");
+
+    std::printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
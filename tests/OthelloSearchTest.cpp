@@ -0,0 +1,100 @@
+#include "OthelloSearch.h"
+#include "OthelloSolver.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//
+// OthelloSearchTest: the search, deepened to the end of the game, against the exact solver
+//
+//   OthelloSearchTest [positions] [max-empties]
+//
+// positions come from seeded random games, stopped with 1 to max-empties (12 by
+// default) squares left. a search with no depth limit must report an exact score
+// equal to the solver's, and the move it picks must keep that score. a search
+// stopped short of the end of the game must not claim its score is exact.
+//
+namespace {
+
+struct Position
+{
+    OthelloBoard board;
+    int          player;
+};
+
+// a random game played down to the given number of empty squares, with the side to move able to move
+bool randomPosition(std::mt19937 &random, int empties, Position &position)
+{
+    OthelloBoard board;
+    int player = OthelloBoard::BLACK_PLAYER;
+    while (std::popcount(board.emptySquares()) > empties) {
+        uint64_t moves = board.legalMoves(player);
+        if (!moves) {
+            player = 1 - player;
+            moves = board.legalMoves(player);
+            if (!moves) return false;
+        }
+        for (int skip = (int)(random() % std::popcount(moves)); skip > 0; skip--) moves &= moves - 1;
+        const int square = std::countr_zero(moves);
+        board.play(square, board.flips(square, player), player);
+        player = 1 - player;
+    }
+    if (!board.hasValidMove(player)) player = 1 - player;
+    position = {board, player};
+    return board.hasValidMove(player);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 400;
+    const int maxEmpties = argc > 2 ? std::atoi(argv[2]) : 12;
+    if (count < 1 || maxEmpties < 1) {
+        std::fprintf(stderr, "usage: %s [positions] [max-empties]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 random(20240601);
+    OthelloSearch search(16);
+    OthelloSolver solver(16);
+    int checked = 0, failures = 0;
+    while (checked < count) {
+        Position position;
+        const int empties = 1 + (int)(random() % maxEmpties);
+        if (!randomPosition(random, empties, position))
+            continue;
+        checked++;
+        const uint64_t own = position.board.discs(position.player);
+        const uint64_t other = position.board.discs(1 - position.player);
+        const int expected = solver.solve(own, other);
+
+        search.newGame();
+        const OthelloSearchResult result = search.search(position.board, position.player, OthelloSearchLimits());
+        const uint64_t flipped = OthelloBoard::flips(own, other, result.move);
+        const int moveScore = -solver.solve(other & ~flipped, own | flipped | (uint64_t(1) << result.move));
+        if (!result.exact || OthelloSearch::discDifference(result.score) != expected || moveScore != expected) {
+            std::printf("FAIL %s %d: search %s%+d with %c%c (worth %+d), solver %+d\n",
+                        position.board.stateString().c_str(), position.player, result.exact ? "=" : "~",
+                        OthelloSearch::discDifference(result.score), 'a' + result.move % OthelloBoard::SIZE,
+                        '1' + result.move / OthelloBoard::SIZE, moveScore, expected);
+            failures++;
+        }
+
+        // one ply short of the end is never proven, whatever score it finds
+        if (empties > 1) {
+            OthelloSearchLimits limits;
+            limits.maxDepth = empties - 1;
+            search.newGame();
+            if (search.search(position.board, position.player, limits).exact) {
+                std::printf("FAIL %s %d: depth %d claims an exact score with %d empties\n",
+                            position.board.stateString().c_str(), position.player, limits.maxDepth, empties);
+                failures++;
+            }
+        }
+    }
+
+    std::printf("%d positions, %d failures\n", checked, failures);
+    return failures ? 1 : 0;
+}
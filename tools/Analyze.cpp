@@ -0,0 +1,323 @@
+#include "Connect4Endgame.h"
+#include "Connect4Search.h"
+#include "OthelloBoard.h"
+#include "OthelloPatterns.h"
+#include "OthelloSearch.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// analyze: score a file of positions on every core
+//
+//   analyze [file|-] [--depth=D] [--time=MS] [--threads=N] [--table=MB] [--player=N] [--endgame=FILE] [--solve=E]
+//          [--weights=FILE]
+//
+// positions are read one per line from the file or stdin, as a 42-character
+// Connect4::stateString or a 64-character Othello::stateString; the length tells
+// them apart. Othello state strings do not record the side to move, so a second
+// field on the line gives it (0 = black), falling back to --player.
+//
+// each position is one task on a work-stealing thread pool, searched by a
+// single-threaded engine owned by the worker. results are written in input
+// order, one line each: the position, best move, score, depth reached and nodes.
+// Connect4 moves are 1-based columns, Othello moves square names such as d3.
+// the totals, including positions per second, go to stderr.
+//
+// a worker keeps its transposition table from one position to the next, so node
+// counts depend on which worker took which positions and vary between runs.
+//
+// Othello is scored by the game's own AI search with the same limits, and by the
+// exact solver when E or fewer squares are empty. a score proven to the end of
+// the game is printed as the final disc difference with an = sign, such as =+6.
+// a game end the search reached before it could see the end of every line is
+// printed with ~ instead, such as ~+42: it rests on the evaluation of the lines
+// cut short, and the exact result can be far from it.
+// --weights evaluates with a pattern weights file from otrain instead of the
+// hand-tuned evaluation.
+//
+namespace {
+
+struct Options
+{
+    int depth = 12;
+    int timeMs = 0;
+    int threads = 0;
+    size_t tableMegabytes = 16;
+    int player = 0;
+    std::string endgame;
+    int solveEmpties = 0;
+    std::string weights;
+};
+
+struct Analysis
+{
+    std::string move = "-";     // when there is nothing to play
+    std::string score = "0";
+    int depth = 0;
+    uint64_t nodes = 0;
+};
+
+// one engine per pool worker, created by the worker the first time it needs it
+struct Engines
+{
+    const Options *options;
+    const Connect4Endgame *endgame;
+    const OthelloPatterns *patterns;
+    std::vector<std::unique_ptr<Connect4Search>> connect4;
+    std::vector<std::unique_ptr<OthelloSearch>> othello;
+
+    Connect4Search &connect4Search()
+    {
+        std::unique_ptr<Connect4Search> &search = connect4[ThreadPool::workerIndex()];
+        if (!search) {
+            search = std::make_unique<Connect4Search>(options->tableMegabytes);
+            search->setEndgame(endgame);
+        }
+        return *search;
+    }
+
+    OthelloSearch &othelloSearch()
+    {
+        std::unique_ptr<OthelloSearch> &search = othello[ThreadPool::workerIndex()];
+        if (!search) {
+            search = std::make_unique<OthelloSearch>(options->tableMegabytes);
+            search->setPatterns(patterns);
+        }
+        return *search;
+    }
+};
+
+bool analyzeConnect4(Engines &engines, const std::string &state, Analysis &analysis)
+{
+    Connect4Board board;
+    if (!board.setStateString(state))
+        return false;
+
+    if (board.outcome().winner >= 0 || board.isFull())
+        return true;
+
+    Connect4SearchLimits limits;
+    limits.maxDepth = engines.options->depth;
+    limits.timeBudgetMs = engines.options->timeMs;
+    const Connect4SearchResult result = engines.connect4Search().search(board, limits);
+    if (result.move >= 0)
+        analysis.move = std::to_string(result.move + 1);
+    analysis.score = std::to_string(result.score);
+    analysis.depth = result.depth;
+    analysis.nodes = result.stats.nodes;
+    return true;
+}
+
+bool analyzeOthello(Engines &engines, const std::string &state, int player, Analysis &analysis)
+{
+    OthelloBoard board;
+    if (!board.setStateString(state))
+        return false;
+
+    if (board.isGameOver()) {
+        char score[16];
+        std::snprintf(score, sizeof(score), "=%+d", OthelloSearch::discDifference(
+                      OthelloSearch::finalScore(board.discs(player), board.discs(1 - player))));
+        analysis.score = score;
+        return true;
+    }
+    if (!board.hasValidMove(player)) {
+        analysis.move = "pass";
+        return true;
+    }
+
+    OthelloSearchLimits limits;
+    limits.maxDepth = engines.options->depth;
+    limits.timeBudgetMs = engines.options->timeMs;
+    limits.solveEmpties = engines.options->solveEmpties;
+    const OthelloSearchResult result = engines.othelloSearch().search(board, player, limits);
+    const char name[3] = {(char)('a' + result.move % OthelloBoard::SIZE), (char)('1' + result.move / OthelloBoard::SIZE), '\0'};
+    analysis.move = name;
+    if (OthelloSearch::isFinalScore(result.score)) {
+        char score[16];
+        std::snprintf(score, sizeof(score), "%c%+d", result.exact ? '=' : '~', OthelloSearch::discDifference(result.score));
+        analysis.score = score;
+    } else {
+        analysis.score = std::to_string(result.score);
+    }
+    analysis.depth = result.depth;
+    analysis.nodes = result.stats.nodes;
+    return true;
+}
+
+// text of one output line; empty for a blank line
+std::string analyzeLine(Engines &engines, const std::string &line, bool &ok, uint64_t &nodes)
+{
+    std::istringstream in(line);
+    std::string state;
+    ok = true;
+    if (!(in >> state))
+        return "";
+
+    Analysis analysis;
+    if ((int)state.length() == Connect4Board::CELLS) {
+        ok = analyzeConnect4(engines, state, analysis);
+    } else if ((int)state.length() == OthelloBoard::SIZE * OthelloBoard::SIZE) {
+        int player = engines.options->player;
+        in >> player;
+        ok = (player == 0 || player == 1) && analyzeOthello(engines, state, player, analysis);
+    } else {
+        ok = false;
+    }
+    if (!ok)
+        return state + "  bad position\n";
+    nodes = analysis.nodes;
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "  best %s  score %s  depth %d  nodes %llu\n", analysis.move.c_str(),
+                  analysis.score.c_str(), analysis.depth, (unsigned long long)analysis.nodes);
+    return state + text;
+}
+
+// finished lines waiting for the ones before them, so the output keeps the input order
+class OrderedOutput
+{
+public:
+    explicit OrderedOutput(size_t maxInFlight) : _maxInFlight(maxInFlight), _submitted(0), _written(0) {}
+
+    // the index for the next line, once fewer than maxInFlight lines are outstanding
+    size_t      reserve()
+    {
+        std::unique_lock<std::mutex> guard(_lock);
+        _space.wait(guard, [this] { return _submitted - _written < _maxInFlight; });
+        return _submitted++;
+    }
+
+    void        finish(size_t index, std::string text)
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _done[index] = std::move(text);
+        for (auto it = _done.find(_written); it != _done.end(); it = _done.find(_written)) {
+            std::fputs(it->second.c_str(), stdout);
+            _done.erase(it);
+            _written++;
+        }
+        _space.notify_one();
+    }
+
+private:
+    std::mutex  _lock;
+    std::condition_variable _space;
+    std::map<size_t, std::string> _done;
+    size_t      _maxInFlight;
+    size_t      _submitted;
+    size_t      _written;
+};
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s [file|-] [--depth=D] [--time=MS] [--threads=N] [--table=MB] [--player=N] [--endgame=FILE] [--solve=E] [--weights=FILE]\n", program);
+    return 1;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    std::string path = "-";
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--depth=", 8) == 0) {
+            options.depth = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--time=", 7) == 0) {
+            options.timeMs = std::atoi(argv[i] + 7);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            options.threads = std::atoi(argv[i] + 10);
+        } else if (std::strncmp(argv[i], "--table=", 8) == 0) {
+            options.tableMegabytes = (size_t)std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--player=", 9) == 0) {
+            options.player = std::atoi(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--endgame=", 10) == 0) {
+            options.endgame = argv[i] + 10;
+        } else if (std::strncmp(argv[i], "--solve=", 8) == 0) {
+            options.solveEmpties = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--weights=", 10) == 0) {
+            options.weights = argv[i] + 10;
+        } else if (argv[i][0] != '-' || argv[i][1] == '\0') {
+            path = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.depth < 0 || options.timeMs < 0 || (options.depth == 0 && options.timeMs == 0) ||
+        (options.player != 0 && options.player != 1))
+        return usage(argv[0]);
+
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            std::fprintf(stderr, "cannot read %s\n", path.c_str());
+            return 1;
+        }
+    }
+    std::istream &in = path == "-" ? std::cin : file;
+
+    Connect4Endgame endgame;
+    if (!options.endgame.empty() && !endgame.open(options.endgame)) {
+        std::fprintf(stderr, "cannot open endgame database %s\n", options.endgame.c_str());
+        return 1;
+    }
+
+    OthelloPatterns patterns;
+    if (!options.weights.empty() && !patterns.open(options.weights)) {
+        std::fprintf(stderr, "cannot open weights %s\n", options.weights.c_str());
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    Engines engines = {&options, endgame.isOpen() ? &endgame : nullptr, &patterns, {}, {}};
+    engines.connect4.resize(pool.threadCount());
+    engines.othello.resize(pool.threadCount());
+
+    // enough lines in flight to keep every worker busy while memory stays bounded
+    OrderedOutput output((size_t)pool.threadCount() * 64);
+    std::atomic<int> positions(0), bad(0);
+    std::atomic<uint64_t> nodes(0);
+    const auto start = std::chrono::steady_clock::now();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t index = output.reserve();
+        pool.submit([&, index, line] {
+            bool ok;
+            uint64_t lineNodes = 0;
+            std::string text = analyzeLine(engines, line, ok, lineNodes);
+            if (!text.empty()) {
+                positions++;
+                nodes += lineNodes;
+                if (!ok) bad++;
+            }
+            output.finish(index, std::move(text));
+        });
+    }
+    pool.wait();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%d positions  %d threads  %.2f s  %.0f positions/s  %.0f nodes/s",
+                 positions.load(), pool.threadCount(), seconds, seconds > 0.0 ? positions / seconds : 0.0,
+                 seconds > 0.0 ? nodes / seconds : 0.0);
+    if (bad)
+        std::fprintf(stderr, "  %d bad", bad.load());
+    std::fprintf(stderr, "\n");
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+#include "Connect4Book.h"
+#include "Connect4Search.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+//
+// c4book: fill a Connect4 opening book offline
+//
+//   c4book <out.book> [--ply=N] [--depth=D] [--threads=T] [--table=MB]
+//
+// every undecided position up to N plies is searched to depth D. positions are
+// split across T threads (0, the default, uses every core), each with its own
+// single-threaded search and table, so the run scales with the core count.
+//
+namespace {
+
+struct Options
+{
+    std::string path;
+    int maxPly = 8;
+    int depth = 16;
+    int threads = 0;
+    int tableMegabytes = 64;
+};
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s <out.book> [--ply=N] [--depth=D] [--threads=T] [--table=MB]\n", program);
+    return 1;
+}
+
+// one representative per mirror pair of every reachable, undecided position up to maxPly
+std::vector<Connect4Board> collectPositions(int maxPly)
+{
+    std::vector<Connect4Board> positions;
+    std::vector<Connect4Board> frontier(1);
+    std::unordered_set<uint64_t> seen;
+
+    for (int ply = 0; ply <= maxPly && !frontier.empty(); ply++) {
+        std::vector<Connect4Board> next;
+        for (const Connect4Board &board : frontier) {
+            positions.push_back(board);
+            if (ply == maxPly)
+                continue;
+            for (int col = 0; col < Connect4Board::WIDTH; col++) {
+                if (!board.canPlay(col) || board.isWinningMove(col))
+                    continue;
+                Connect4Board child = board;
+                child.play(col);
+                bool mirrored;
+                if (!child.isFull() && seen.insert(Connect4Book::canonicalKey(child, mirrored)).second)
+                    next.push_back(child);
+            }
+        }
+        std::printf("ply %2d: %zu positions\n", ply, frontier.size());
+        frontier.swap(next);
+    }
+    return positions;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--ply=", 6) == 0) {
+            options.maxPly = std::atoi(argv[i] + 6);
+        } else if (std::strncmp(argv[i], "--depth=", 8) == 0) {
+            options.depth = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            options.threads = std::atoi(argv[i] + 10);
+        } else if (std::strncmp(argv[i], "--table=", 8) == 0) {
+            options.tableMegabytes = std::atoi(argv[i] + 8);
+        } else if (argv[i][0] != '-' && options.path.empty()) {
+            options.path = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.path.empty() || options.maxPly < 0 || options.maxPly >= Connect4Board::WIDTH * Connect4Board::HEIGHT ||
+        options.depth < 1 || options.threads < 0 || options.tableMegabytes < 1)
+        return usage(argv[0]);
+
+    int threads = options.threads;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::vector<Connect4Board> positions = collectPositions(options.maxPly);
+    std::printf("searching %zu positions to depth %d on %d threads\n", positions.size(), options.depth, threads);
+
+    std::vector<uint64_t> entries(positions.size());
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<size_t> done(0);
+    std::mutex printMutex;
+    const auto start = std::chrono::steady_clock::now();
+
+    auto work = [&]() {
+        Connect4Search search(options.tableMegabytes);
+        Connect4SearchLimits limits;
+        limits.maxDepth = options.depth;
+        for (size_t i = nextIndex++; i < positions.size(); i = nextIndex++) {
+            const Connect4Board &board = positions[i];
+            const Connect4SearchResult result = search.search(board, limits);
+
+            // store in the canonical orientation; probe() reflects it back for the mirror
+            bool mirrored;
+            const uint64_t key = Connect4Book::canonicalKey(board, mirrored);
+            const int move = mirrored ? Connect4Board::WIDTH - 1 - result.move : result.move;
+            entries[i] = Connect4Book::packEntry(key, move, result.score);
+
+            const size_t finished = ++done;
+            if (finished % 1000 == 0 || finished == positions.size()) {
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::lock_guard<std::mutex> lock(printMutex);
+                std::printf("%zu / %zu  %.1f s\n", finished, positions.size(), seconds);
+                std::fflush(stdout);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+        worker.join();
+
+    if (!Connect4Book::write(options.path, entries, options.maxPly, options.depth)) {
+        std::fprintf(stderr, "cannot write %s\n", options.path.c_str());
+        return 1;
+    }
+    std::printf("wrote %zu entries to %s\n", entries.size(), options.path.c_str());
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "Connect4Endgame.h"
+#include "Connect4Search.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+// c4endgame: build a Connect4 endgame database offline
+//
+//   c4endgame <out.endgame> [--empty=N] [--min-empty=M] [--games=G] [--random=R] [--depth=D] [--seed=S]
+//
+// every position with N or fewer empty cells is far too many to store (the
+// count runs into the hundreds of billions for N = 12), so the database covers
+// the endgames of G sample games instead, and nothing else. each game opens
+// with R random moves that never hand the opponent an immediate win, then the
+// depth-D search plays both sides until N cells are left, so the endgames look
+// like the ones the AI reaches. from there every reachable position is
+// enumerated and solved exactly by a full minimax that shares its results
+// across games. only the positions with at least M empty cells are written;
+// the rest are quicker to search. N is at most 14, the most the file format
+// holds scores for.
+//
+namespace {
+
+const int CELLS = Connect4Board::CELLS;
+
+struct Options
+{
+    std::string path;
+    int maxEmpty = 14;
+    int minEmpty = 12;
+    int games = 20000;
+    int randomPlies = 8;
+    int depth = 6;
+    unsigned seed = 1;
+};
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s <out.endgame> [--empty=N] [--min-empty=M] [--games=G] [--random=R] [--depth=D] [--seed=S]\n", program);
+    return 1;
+}
+
+class Enumerator
+{
+public:
+    // exact Connect4Solver score of an undecided position, storing it and everything below
+    int solve(const Connect4Board &board)
+    {
+        if (board.isFull())
+            return 0;
+        for (int col = 0; col < Connect4Board::WIDTH; col++) {
+            if (board.canPlay(col) && board.isWinningMove(col))
+                return (CELLS + 1 - board.moveCount()) / 2;
+        }
+
+        const uint64_t key = Connect4Endgame::canonicalKey(board);
+        const auto found = _scores.find(key);
+        if (found != _scores.end())
+            return found->second.score;
+
+        int best = -CELLS;
+        for (int col = 0; col < Connect4Board::WIDTH; col++) {
+            if (!board.canPlay(col))
+                continue;
+            Connect4Board child = board;
+            child.play(col);
+            const int score = -solve(child);
+            if (score > best)
+                best = score;
+        }
+        _scores.emplace(key, Solved{(int8_t)best, (int8_t)(CELLS - board.moveCount())});
+        return best;
+    }
+
+    size_t size() const { return _scores.size(); }
+
+    // the solved positions with at least minEmpty empty cells
+    std::vector<uint64_t> entries(int minEmpty) const
+    {
+        std::vector<uint64_t> entries;
+        for (const auto &score : _scores) {
+            if (score.second.empty >= minEmpty)
+                entries.push_back(Connect4Endgame::packEntry(score.first, score.second.score));
+        }
+        return entries;
+    }
+
+private:
+    struct Solved
+    {
+        int8_t score;
+        int8_t empty;
+    };
+    std::unordered_map<uint64_t, Solved> _scores;
+};
+
+// a sample game stopped with maxEmpty cells left; false if it was decided before that
+bool sampleRoot(std::mt19937 &random, Connect4Search &search, const Options &options, Connect4Board &board)
+{
+    board = Connect4Board();
+    search.newGame();
+    while (CELLS - board.moveCount() > options.maxEmpty) {
+        const uint64_t moves = board.nonLosingMoves();
+        if (!moves || (Connect4Board::winningCells(board.stones(board.currentPlayer()), board.mask()) & board.playableCells()))
+            return false;
+
+        int col;
+        if (board.moveCount() < options.randomPlies) {
+            int pick = (int)(random() % (unsigned)Connect4Board::popcount(moves));
+            uint64_t cell = moves;
+            while (pick-- > 0)
+                cell &= cell - 1;
+            col = std::countr_zero(cell) / (Connect4Board::HEIGHT + 1);
+        } else {
+            col = search.findBestMove(board, options.depth);
+        }
+        board.play(col);
+        if (board.lastMoveOutcome().winner >= 0)
+            return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--empty=", 8) == 0) {
+            options.maxEmpty = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--min-empty=", 12) == 0) {
+            options.minEmpty = std::atoi(argv[i] + 12);
+        } else if (std::strncmp(argv[i], "--games=", 8) == 0) {
+            options.games = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--random=", 9) == 0) {
+            options.randomPlies = std::atoi(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--depth=", 8) == 0) {
+            options.depth = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            options.seed = (unsigned)std::strtoul(argv[i] + 7, nullptr, 10);
+        } else if (argv[i][0] != '-' && options.path.empty()) {
+            options.path = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.path.empty() || options.maxEmpty < 1 || options.maxEmpty > Connect4Endgame::MAX_EMPTY ||
+        options.minEmpty < 0 || options.minEmpty > options.maxEmpty || options.games < 1 ||
+        options.randomPlies < 0 || options.depth < 1)
+        return usage(argv[0]);
+
+    std::mt19937 random(options.seed);
+    Connect4Search search(4);
+    Enumerator enumerator;
+    const auto start = std::chrono::steady_clock::now();
+    int roots = 0;
+    for (int game = 0; game < options.games; game++) {
+        Connect4Board root;
+        if (sampleRoot(random, search, options, root)) {
+            enumerator.solve(root);
+            roots++;
+        }
+        if ((game + 1) % 100 == 0 || game + 1 == options.games) {
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::printf("game %d / %d  %d roots  %zu positions  %.1f s\n", game + 1, options.games, roots, enumerator.size(), seconds);
+            std::fflush(stdout);
+        }
+    }
+
+    const std::vector<uint64_t> entries = enumerator.entries(options.minEmpty);
+    if (!Connect4Endgame::write(options.path, entries, options.minEmpty, options.maxEmpty)) {
+        std::fprintf(stderr, "cannot write %s\n", options.path.c_str());
+        return 1;
+    }
+    std::printf("wrote %zu positions to %s\n", entries.size(), options.path.c_str());
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "Connect4Solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// c4solve: exact Connect4 results for a list of positions
+//
+//   c4solve [--best] [--table=MB] [position ...]
+//
+// positions come from the arguments, or one per line on stdin. a position is a
+// 42-character Connect4 state string, or a sequence of 1-based columns as in the
+// common solver test sets ("4453"); a second number on the line is the expected
+// score and is checked. --best also finds the best column (one solve per column).
+//
+namespace {
+
+bool parsePosition(const std::string &text, Connect4Board &board)
+{
+    board = Connect4Board();
+    if ((int)text.length() == Connect4Board::WIDTH * Connect4Board::HEIGHT &&
+        text.find_first_not_of("012") == std::string::npos)
+        return board.setStateString(text);
+
+    for (char c : text) {
+        const int col = c - '1';
+        if (col < 0 || col >= Connect4Board::WIDTH || !board.canPlay(col) || board.lastMoveOutcome().winner >= 0)
+            return false;
+        board.play(col);
+    }
+    return true;
+}
+
+struct Totals
+{
+    int positions = 0;
+    int mismatches = 0;
+    uint64_t nodes = 0;
+    double timeMs = 0.0;
+    double maxTimeMs = 0.0;
+};
+
+bool solveLine(Connect4Solver &solver, const std::string &line, bool best, Totals &totals)
+{
+    std::istringstream in(line);
+    std::string text;
+    if (!(in >> text))
+        return true;
+
+    Connect4Board board;
+    if (!parsePosition(text, board)) {
+        std::fprintf(stderr, "bad position: %s\n", text.c_str());
+        return false;
+    }
+
+    Connect4SolveResult result;
+    if (best) {
+        result = solver.bestMove(board);
+    } else {
+        const uint64_t nodes = solver.nodes();
+        const auto start = std::chrono::steady_clock::now();
+        result.score = solver.solve(board);
+        result.pliesToEnd = Connect4Solver::pliesToEnd(board, result.score);
+        result.nodes = solver.nodes() - nodes;
+        result.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::printf("%s  score %d", text.c_str(), result.score);
+    if (result.score != 0)
+        std::printf(" (%s in %d)", result.score > 0 ? "win" : "loss", result.pliesToEnd);
+    if (best)
+        std::printf("  best %d", result.move + 1);
+    std::printf("  nodes %llu  %.2f ms", (unsigned long long)result.nodes, result.timeMs);
+
+    int expected;
+    if (in >> expected && expected != result.score) {
+        std::printf("  EXPECTED %d", expected);
+        totals.mismatches++;
+    }
+    std::printf("\n");
+
+    totals.positions++;
+    totals.nodes += result.nodes;
+    totals.timeMs += result.timeMs;
+    if (result.timeMs > totals.maxTimeMs)
+        totals.maxTimeMs = result.timeMs;
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    bool best = false;
+    size_t tableMegabytes = 64;
+    std::vector<std::string> positions;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--best") == 0) {
+            best = true;
+        } else if (std::strncmp(argv[i], "--table=", 8) == 0) {
+            tableMegabytes = (size_t)std::atoi(argv[i] + 8);
+        } else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "usage: %s [--best] [--table=MB] [position ...]\n", argv[0]);
+            return 1;
+        } else {
+            positions.push_back(argv[i]);
+        }
+    }
+
+    Connect4Solver solver(tableMegabytes);
+    Totals totals;
+    bool ok = true;
+    if (positions.empty()) {
+        std::string line;
+        while (std::getline(std::cin, line))
+            ok = solveLine(solver, line, best, totals) && ok;
+    } else {
+        for (const std::string &position : positions)
+            ok = solveLine(solver, position, best, totals) && ok;
+    }
+
+    if (totals.positions > 1) {
+        std::printf("%d positions  mean %.2f ms  max %.2f ms  mean nodes %.0f  %.0f nodes/s",
+                    totals.positions, totals.timeMs / totals.positions, totals.maxTimeMs,
+                    (double)totals.nodes / totals.positions,
+                    totals.timeMs > 0.0 ? totals.nodes / (totals.timeMs / 1000.0) : 0.0);
+        if (totals.mismatches)
+            std::printf("  %d WRONG", totals.mismatches);
+        std::printf("\n");
+    }
+    return ok && totals.mismatches == 0 ? 0 : 1;
+}
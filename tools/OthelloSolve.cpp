@@ -0,0 +1,157 @@
+#include "OthelloSolver.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// osolve: exact Othello endgame results for a list of positions
+//
+//   osolve [--player=N] [--table=MB] [position ...]
+//
+// positions come from the arguments (one quoted line each), or one per line on
+// stdin. a position is a 64-character board, either an Othello::stateString ('0'
+// empty, '1' black, '2' white) or the layout of the common endgame test suites
+// ('-' empty, 'X' black, 'O' white), followed by the side to move (0 or X for
+// black, 1 or O for white, --player when it is missing; a trailing ';' is
+// ignored) and optionally the expected score, which is checked. the score is the exact final disc difference
+// for the side to move, the empty squares of a finished game going to the winner.
+//
+// each line prints the score, a best move, the nodes searched, the solve time and
+// nodes per second; the totals follow when there is more than one position. the
+// solver's table is kept between positions, as it is in a game.
+//
+namespace {
+
+// the board part of a line in either notation
+bool parseBoard(const std::string &text, OthelloBoard &board)
+{
+    if ((int)text.length() != OthelloBoard::SIZE * OthelloBoard::SIZE)
+        return false;
+    std::string state = text;
+    for (char &c : state) {
+        if (c == '-' || c == '.') c = '0';
+        else if (c == 'X' || c == 'x' || c == '*') c = '1';
+        else if (c == 'O' || c == 'o') c = '2';
+    }
+    return board.setStateString(state);
+}
+
+// 0 for black, 1 for white, -1 for anything else
+int parsePlayer(std::string text)
+{
+    if (!text.empty() && text.back() == ';')
+        text.pop_back();
+    if (text == "0" || text == "X" || text == "x" || text == "B" || text == "b")
+        return OthelloBoard::BLACK_PLAYER;
+    if (text == "1" || text == "O" || text == "o" || text == "W" || text == "w")
+        return OthelloBoard::WHITE_PLAYER;
+    return -1;
+}
+
+struct Totals
+{
+    int positions = 0;
+    int mismatches = 0;
+    uint64_t nodes = 0;
+    double timeMs = 0.0;
+    double maxTimeMs = 0.0;
+};
+
+bool solveLine(OthelloSolver &solver, const std::string &line, int defaultPlayer, Totals &totals)
+{
+    std::istringstream in(line);
+    std::string text;
+    if (!(in >> text))
+        return true;
+
+    OthelloBoard board;
+    if (!parseBoard(text, board)) {
+        std::fprintf(stderr, "bad position: %s\n", text.c_str());
+        return false;
+    }
+    int player = defaultPlayer;
+    std::string field;
+    if (in >> field) {
+        player = parsePlayer(field);
+        if (player < 0) {
+            std::fprintf(stderr, "bad side to move: %s\n", field.c_str());
+            return false;
+        }
+    }
+
+    const OthelloSolveResult result = solver.bestMove(board, player);
+    std::printf("%s  %s  score %+d", text.c_str(), player == OthelloBoard::BLACK_PLAYER ? "black" : "white", result.score);
+    if (result.move >= 0)
+        std::printf("  best %c%c", 'a' + result.move % OthelloBoard::SIZE, '1' + result.move / OthelloBoard::SIZE);
+    else
+        std::printf("  best %s", board.isGameOver() ? "-" : "pass");
+    std::printf("  nodes %llu  %.2f ms  %.0f nodes/s", (unsigned long long)result.nodes, result.timeMs,
+                result.timeMs > 0.0 ? result.nodes / (result.timeMs / 1000.0) : 0.0);
+
+    int expected;
+    if (in >> expected && expected != result.score) {
+        std::printf("  EXPECTED %+d", expected);
+        totals.mismatches++;
+    }
+    std::printf("\n");
+
+    totals.positions++;
+    totals.nodes += result.nodes;
+    totals.timeMs += result.timeMs;
+    if (result.timeMs > totals.maxTimeMs)
+        totals.maxTimeMs = result.timeMs;
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    int player = OthelloBoard::BLACK_PLAYER;
+    size_t tableMegabytes = 64;
+    std::vector<std::string> positions;
+    for (int i = 1; i < argc; i++) {
+        // test-suite boards can start with "--" too
+        if (std::strlen(argv[i]) >= (size_t)(OthelloBoard::SIZE * OthelloBoard::SIZE)) {
+            positions.push_back(argv[i]);
+        } else if (std::strncmp(argv[i], "--player=", 9) == 0) {
+            player = parsePlayer(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--table=", 8) == 0) {
+            tableMegabytes = (size_t)std::atoi(argv[i] + 8);
+        } else {
+            player = -1;
+            break;
+        }
+    }
+    if (player < 0) {
+        std::fprintf(stderr, "usage: %s [--player=N] [--table=MB] [position ...]\n", argv[0]);
+        return 1;
+    }
+
+    OthelloSolver solver(tableMegabytes);
+    Totals totals;
+    bool ok = true;
+    if (positions.empty()) {
+        std::string line;
+        while (std::getline(std::cin, line))
+            ok = solveLine(solver, line, player, totals) && ok;
+    } else {
+        for (const std::string &position : positions)
+            ok = solveLine(solver, position, player, totals) && ok;
+    }
+
+    if (totals.positions > 1) {
+        std::printf("%d positions  total %.2f s  mean %.2f ms  max %.2f ms  mean nodes %.0f  %.0f nodes/s",
+                    totals.positions, totals.timeMs / 1000.0, totals.timeMs / totals.positions, totals.maxTimeMs,
+                    (double)totals.nodes / totals.positions,
+                    totals.timeMs > 0.0 ? totals.nodes / (totals.timeMs / 1000.0) : 0.0);
+        if (totals.mismatches)
+            std::printf("  %d WRONG", totals.mismatches);
+        std::printf("\n");
+    }
+    return ok && totals.mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+#include "OthelloPatterns.h"
+#include "OthelloSearch.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//
+// otrain: fit Othello pattern weights from self-play on every core
+//
+//   otrain <out.weights> [--games=G] [--random=R] [--depth=D] [--solve=E] [--epochs=N]
+//          [--rate=L] [--threads=T] [--seed=S] [--weights=FILE]
+//
+// G games are played as tasks on a work-stealing thread pool, each opening with
+// R random moves and continued by the depth-D search for both sides. the exact
+// solver plays the last E moves, so the end of every game is perfect play.
+// with --weights the search evaluates with an earlier weights file, so each
+// round of training plays better games for the next one.
+//
+// every position with a move to play becomes a sample: its pattern indices
+// and the final disc difference from the side to move's point of view. one game
+// in ten is held out to measure how well the weights predict unseen games.
+//
+// each phase is fitted on its own task by gradient descent on the squared error.
+// a phase also trains on the samples of the phases next to it, so weights change
+// smoothly with the disc count and rare patterns borrow data from their
+// neighbours. the step for a weight is divided by how many samples use it, so
+// common and rare patterns settle at the same pace.
+//
+namespace {
+
+// samples a weight's step is damped by, so weights seen a few times stay near zero
+const double SMOOTHING = 16.0;
+
+struct Options
+{
+    std::string path;
+    int games = 20000;
+    int randomPlies = 8;
+    int depth = 2;
+    int solveEmpties = 14;
+    int epochs = 100;
+    double rate = 1.0;
+    int threads = 0;
+    unsigned seed = 1;
+    std::string weights;
+};
+
+struct Sample
+{
+    uint16_t indices[OthelloPatterns::INSTANCE_COUNT];
+    int8_t  phase;
+    int8_t  score;      // final disc difference for the side to move
+};
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s <out.weights> [--games=G] [--random=R] [--depth=D] [--solve=E] [--epochs=N] "
+                         "[--rate=L] [--threads=T] [--seed=S] [--weights=FILE]\n", program);
+    return 1;
+}
+
+struct Game
+{
+    std::vector<Sample> samples;
+    bool        validation = false;
+};
+
+// play one game and turn every position in it into a sample
+void playGame(OthelloSearch &search, const Options &options, unsigned seed, Game &game)
+{
+    std::mt19937 rng(seed);
+    OthelloSearchLimits limits;
+    limits.maxDepth = options.depth;
+    limits.solveEmpties = options.solveEmpties;
+    search.newGame();
+
+    struct Position {
+        uint64_t own, other;
+        int player;
+    };
+    std::vector<Position> positions;
+    OthelloBoard board;
+    int player = OthelloBoard::BLACK_PLAYER;
+    for (int ply = 0; !board.isGameOver(); ply++) {
+        const uint64_t moves = board.legalMoves(player);
+        if (!moves) {
+            player = 1 - player;
+            continue;
+        }
+        positions.push_back({board.discs(player), board.discs(1 - player), player});
+        int square;
+        if (ply < options.randomPlies) {
+            uint64_t bits = moves;
+            for (int skip = (int)(rng() % std::popcount(moves)); skip > 0; skip--) bits &= bits - 1;
+            square = std::countr_zero(bits);
+        } else {
+            square = search.search(board, player, limits).move;
+        }
+        board.play(square, board.flips(square, player), player);
+        player = 1 - player;
+    }
+
+    const int blackScore = OthelloSolver::finalScore(board.discs(OthelloBoard::BLACK_PLAYER),
+                                                     board.discs(OthelloBoard::WHITE_PLAYER));
+    game.samples.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        Sample &sample = game.samples[i];
+        OthelloPatterns::indices(positions[i].own, positions[i].other, sample.indices);
+        sample.phase = (int8_t)OthelloPatterns::phase(std::popcount(positions[i].own | positions[i].other));
+        sample.score = (int8_t)(positions[i].player == OthelloBoard::BLACK_PLAYER ? blackScore : -blackScore);
+    }
+}
+
+struct PhaseResult
+{
+    size_t      samples = 0;
+    double      trainError = 0.0;       // root mean square, in discs
+    double      validationError = 0.0;
+    size_t      validationSamples = 0;
+};
+
+double predict(const std::vector<float> &weights, const std::vector<int> &offsets, const Sample &sample)
+{
+    const std::vector<OthelloPatterns::Instance> &instances = OthelloPatterns::instances();
+    double score = weights[offsets[OthelloPatterns::PATTERN_BIAS]];
+    for (int i = 0; i < OthelloPatterns::INSTANCE_COUNT; i++)
+        score += weights[offsets[instances[i].pattern] + sample.indices[i]];
+    return score;
+}
+
+double rootMeanSquare(const std::vector<float> &weights, const std::vector<int> &offsets,
+                      const std::vector<const Sample *> &samples)
+{
+    double sum = 0.0;
+    for (const Sample *sample : samples) {
+        const double error = sample->score - predict(weights, offsets, *sample);
+        sum += error * error;
+    }
+    return samples.empty() ? 0.0 : std::sqrt(sum / samples.size());
+}
+
+// fit one phase's weights; they are written to out as 1/SCALE discs
+PhaseResult fitPhase(int phase, const std::vector<Game> &games, const Options &options, int16_t *out)
+{
+    const std::vector<OthelloPatterns::Instance> &instances = OthelloPatterns::instances();
+    std::vector<int> offsets(OthelloPatterns::PATTERN_COUNT);
+    for (int p = 0; p < OthelloPatterns::PATTERN_COUNT; p++)
+        offsets[p] = OthelloPatterns::tableOffset((OthelloPatterns::Pattern)p);
+
+    // training samples from this phase and its neighbours; error is reported on this phase alone
+    std::vector<const Sample *> training, trainingPhase, validation;
+    for (const Game &game : games) {
+        for (const Sample &sample : game.samples) {
+            if (game.validation) {
+                if (sample.phase == phase) validation.push_back(&sample);
+            } else if (std::abs(sample.phase - phase) <= 1) {
+                training.push_back(&sample);
+                if (sample.phase == phase) trainingPhase.push_back(&sample);
+            }
+        }
+    }
+
+    const int weightCount = OthelloPatterns::weightsPerPhase();
+    std::vector<float> weights(weightCount, 0.0f);
+    std::vector<float> counts(weightCount, 0.0f);
+    std::vector<double> gradient(weightCount);
+    for (const Sample *sample : training) {
+        counts[offsets[OthelloPatterns::PATTERN_BIAS]] += 1.0f;
+        for (int i = 0; i < OthelloPatterns::INSTANCE_COUNT; i++)
+            counts[offsets[instances[i].pattern] + sample->indices[i]] += 1.0f;
+    }
+
+    for (int epoch = 0; epoch < options.epochs && !training.empty(); epoch++) {
+        std::fill(gradient.begin(), gradient.end(), 0.0);
+        for (const Sample *sample : training) {
+            const double error = sample->score - predict(weights, offsets, *sample);
+            gradient[offsets[OthelloPatterns::PATTERN_BIAS]] += error;
+            for (int i = 0; i < OthelloPatterns::INSTANCE_COUNT; i++)
+                gradient[offsets[instances[i].pattern] + sample->indices[i]] += error;
+        }
+        // a prediction sums INSTANCE_COUNT + 1 weights, so each takes its share of the correction
+        for (int k = 0; k < weightCount; k++) {
+            if (counts[k] > 0.0f)
+                weights[k] += (float)(options.rate * gradient[k] / ((counts[k] + SMOOTHING) * (OthelloPatterns::INSTANCE_COUNT + 1)));
+        }
+    }
+
+    for (int k = 0; k < weightCount; k++) {
+        const float scaled = std::round(weights[k] * OthelloPatterns::SCALE);
+        out[k] = (int16_t)std::clamp(scaled, -32767.0f, 32767.0f);
+    }
+
+    PhaseResult result;
+    result.samples = trainingPhase.size();
+    result.trainError = rootMeanSquare(weights, offsets, trainingPhase);
+    result.validationError = rootMeanSquare(weights, offsets, validation);
+    result.validationSamples = validation.size();
+    return result;
+}
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    bool ok = true;
+    for (int i = 1; i < argc && ok; i++) {
+        if (std::strncmp(argv[i], "--games=", 8) == 0) {
+            options.games = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--random=", 9) == 0) {
+            options.randomPlies = std::atoi(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--depth=", 8) == 0) {
+            options.depth = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--solve=", 8) == 0) {
+            options.solveEmpties = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--epochs=", 9) == 0) {
+            options.epochs = std::atoi(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--rate=", 7) == 0) {
+            options.rate = std::atof(argv[i] + 7);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            options.threads = std::atoi(argv[i] + 10);
+        } else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            options.seed = (unsigned)std::strtoul(argv[i] + 7, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--weights=", 10) == 0) {
+            options.weights = argv[i] + 10;
+        } else if (argv[i][0] != '-' && options.path.empty()) {
+            options.path = argv[i];
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok || options.path.empty() || options.games < 1 || options.depth < 1 || options.epochs < 0 || options.rate <= 0.0)
+        return usage(argv[0]);
+
+    OthelloPatterns patterns;
+    if (!options.weights.empty() && !patterns.open(options.weights)) {
+        std::fprintf(stderr, "cannot open weights %s\n", options.weights.c_str());
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    std::vector<std::unique_ptr<OthelloSearch>> searches(pool.threadCount());
+    std::vector<Game> games(options.games);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int g = 0; g < options.games; g++) {
+        pool.submit([&, g] {
+            std::unique_ptr<OthelloSearch> &search = searches[ThreadPool::workerIndex()];
+            if (!search) {
+                search = std::make_unique<OthelloSearch>(4);
+                search->setPatterns(&patterns);
+            }
+            games[g].validation = g % 10 == 9;
+            playGame(*search, options, options.seed * 1000003u + (unsigned)g, games[g]);
+        });
+    }
+    pool.wait();
+
+    size_t sampleCount = 0;
+    for (const Game &game : games) sampleCount += game.samples.size();
+    std::printf("%d games  %zu positions  %d threads  %.1f s\n", options.games, sampleCount, pool.threadCount(),
+                elapsedSeconds(start));
+    std::fflush(stdout);
+
+    const int weightCount = OthelloPatterns::weightsPerPhase();
+    std::vector<int16_t> weights((size_t)OthelloPatterns::PHASE_COUNT * weightCount);
+    std::vector<PhaseResult> results(OthelloPatterns::PHASE_COUNT);
+    const std::chrono::steady_clock::time_point fitStart = std::chrono::steady_clock::now();
+    for (int phase = 0; phase < OthelloPatterns::PHASE_COUNT; phase++) {
+        pool.submit([&, phase] {
+            results[phase] = fitPhase(phase, games, options, weights.data() + (size_t)phase * weightCount);
+        });
+    }
+    pool.wait();
+
+    for (int phase = 0; phase < OthelloPatterns::PHASE_COUNT; phase++) {
+        const int discs = 4 + phase * OthelloPatterns::DISCS_PER_PHASE;
+        const int lastDiscs = phase == OthelloPatterns::PHASE_COUNT - 1 ? OthelloBoard::SIZE * OthelloBoard::SIZE
+                                                                        : discs + OthelloPatterns::DISCS_PER_PHASE - 1;
+        std::printf("phase %2d  discs %2d-%2d  samples %7zu  train %5.2f  validation %5.2f (%zu)\n", phase, discs,
+                    lastDiscs, results[phase].samples, results[phase].trainError, results[phase].validationError,
+                    results[phase].validationSamples);
+    }
+    std::printf("fitted %d epochs in %.1f s\n", options.epochs, elapsedSeconds(fitStart));
+
+    if (!OthelloPatterns::write(options.path, weights)) {
+        std::fprintf(stderr, "cannot write %s\n", options.path.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", options.path.c_str());
+    return 0;
+}
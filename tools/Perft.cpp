@@ -0,0 +1,341 @@
+#include "CheckersBoard.h"
+#include "Connect4Board.h"
+#include "OthelloBoard.h"
+#include "OthelloReferenceBoard.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//
+// perft: count the leaves of the full legal move tree to a fixed depth
+//
+//   perft <othello[:reference]|checkers|connect4[:WxH]> <depth> [state] [--player=N] [--divide] [--kernel=K]
+//
+// state is the game's stateString (the starting position if omitted or "-").
+// connect4:8x7, :6x5 and :9x7 pick another Connect4 board size. othello:reference
+// runs the original square-by-square Othello rules, to check the bitboard ones, and
+// --kernel=scalar|sse2|avx2 picks the bitboard move generator (the fastest by default).
+// Othello and Checkers state strings do not record the side to move, so it is
+// given with --player (0 = black / red, the default). --divide prints the leaf
+// count under each root move, which is how two generators are bisected when
+// their totals disagree.
+//
+// a turn is one node: in Othello a forced pass is a move of its own, in Checkers
+// a whole jump sequence is one move. a finished game below the requested depth
+// contributes no leaves, the same convention as chess perft.
+//
+namespace {
+
+std::string squareName(int x, int y)
+{
+    char name[3] = {(char)('a' + x), (char)('1' + y), '\0'};
+    return name;
+}
+
+//
+// Othello
+//
+template <class Board>
+struct OthelloPosition
+{
+    Board        board;
+    int          player;
+};
+
+struct OthelloMove
+{
+    int x, y;   // -1, -1 for a pass
+};
+
+template <class Board>
+std::vector<OthelloMove> othelloMoves(const OthelloPosition<Board> &position)
+{
+    std::vector<OthelloMove> moves;
+    for (const std::pair<int, int> &move : position.board.getValidMoves(position.player)) {
+        moves.push_back({move.first, move.second});
+    }
+    if (moves.empty() && position.board.hasValidMove(1 - position.player)) {
+        moves.push_back({-1, -1});
+    }
+    return moves;
+}
+
+template <class Board>
+OthelloPosition<Board> othelloPlay(const OthelloPosition<Board> &position, const OthelloMove &move)
+{
+    OthelloPosition<Board> next = position;
+    if (move.x >= 0) {
+        next.board.play(move.x, move.y, position.player);
+    }
+    next.player = 1 - position.player;
+    return next;
+}
+
+std::string othelloMoveName(const OthelloMove &move)
+{
+    return move.x < 0 ? "pass" : squareName(move.x, move.y);
+}
+
+//
+// Checkers
+//
+struct CheckersPosition
+{
+    CheckersBoard board;
+    int           player;
+};
+
+struct CheckersMove
+{
+    std::vector<int> path;  // x0, y0, x1, y1, ... for every square the piece visits
+    CheckersBoard    result;
+};
+
+// steps the piece on (x, y) can take, using the board's own rule checks
+void checkersSteps(const CheckersBoard &board, int x, int y, bool jumpsOnly, std::vector<std::pair<int, int>> &targets)
+{
+    for (int dy = -2; dy <= 2; dy++) {
+        for (int dx = -2; dx <= 2; dx++) {
+            if (dx == 0 || std::abs(dx) != std::abs(dy)) continue;
+            if (jumpsOnly && !board.isJumpMove(x, y, x + dx, y + dy)) continue;
+            if (board.canMoveFromTo(x, y, x + dx, y + dy)) {
+                targets.push_back({x + dx, y + dy});
+            }
+        }
+    }
+}
+
+// extend a capture that must continue until the piece has no jump left
+void checkersContinue(CheckersMove move, int x, int y, std::vector<CheckersMove> &moves)
+{
+    std::vector<std::pair<int, int>> targets;
+    checkersSteps(move.result, x, y, true, targets);
+    for (const std::pair<int, int> &target : targets) {
+        CheckersMove next = move;
+        const CheckersBoard::StepResult step = next.result.applyStep(x, y, target.first, target.second);
+        next.path.push_back(target.first);
+        next.path.push_back(target.second);
+        if (step.mustContinueJumping) {
+            checkersContinue(next, target.first, target.second, moves);
+        } else {
+            moves.push_back(next);
+        }
+    }
+}
+
+std::vector<CheckersMove> checkersMoves(const CheckersPosition &position)
+{
+    std::vector<CheckersMove> moves;
+    std::vector<std::pair<int, int>> targets;
+    for (int y = 0; y < CheckersBoard::SIZE; y++) {
+        for (int x = 0; x < CheckersBoard::SIZE; x++) {
+            if (CheckersBoard::ownerOf(position.board.pieceAt(x, y)) != position.player) continue;
+            targets.clear();
+            checkersSteps(position.board, x, y, false, targets);
+            for (const std::pair<int, int> &target : targets) {
+                CheckersMove move;
+                move.path = {x, y, target.first, target.second};
+                move.result = position.board;
+                const CheckersBoard::StepResult step = move.result.applyStep(x, y, target.first, target.second);
+                if (step.mustContinueJumping) {
+                    checkersContinue(move, target.first, target.second, moves);
+                } else {
+                    moves.push_back(move);
+                }
+            }
+        }
+    }
+    return moves;
+}
+
+CheckersPosition checkersPlay(const CheckersPosition &position, const CheckersMove &move)
+{
+    return {move.result, 1 - position.player};
+}
+
+std::string checkersMoveName(const CheckersMove &move)
+{
+    const bool jump = std::abs(move.path[2] - move.path[0]) == 2;
+    std::string name = squareName(move.path[0], move.path[1]);
+    for (size_t i = 2; i < move.path.size(); i += 2) {
+        name += jump ? "x" : "-";
+        name += squareName(move.path[i], move.path[i + 1]);
+    }
+    return name;
+}
+
+//
+// Connect4
+//
+template <class Board>
+std::vector<int> connect4Moves(const Board &board)
+{
+    std::vector<int> moves;
+    if (board.lastMoveOutcome().winner >= 0) return moves;
+    for (int col = 0; col < Board::WIDTH; col++) {
+        if (board.canPlay(col)) moves.push_back(col);
+    }
+    return moves;
+}
+
+template <class Board>
+Board connect4Play(const Board &board, int col)
+{
+    Board next = board;
+    next.play(col);
+    return next;
+}
+
+std::string connect4MoveName(int col)
+{
+    return std::to_string(col);
+}
+
+//
+// the walk itself, shared by all three games
+//
+struct Counter
+{
+    uint64_t nodes = 0;     // every position visited, interior and leaf
+};
+
+template <class Position, class Generate, class Play>
+uint64_t perft(const Position &position, int depth, Generate generate, Play play, Counter &counter)
+{
+    counter.nodes++;
+    if (depth == 0) return 1;
+
+    const auto moves = generate(position);
+    if (depth == 1) {
+        // bulk count: the children are leaves, no need to make the moves
+        counter.nodes += moves.size();
+        return moves.size();
+    }
+
+    uint64_t leaves = 0;
+    for (const auto &move : moves) {
+        leaves += perft(play(position, move), depth - 1, generate, play, counter);
+    }
+    return leaves;
+}
+
+template <class Position, class Generate, class Play, class Name>
+void run(const Position &root, int depth, bool divide, Generate generate, Play play, Name name)
+{
+    Counter counter;
+    uint64_t leaves = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    if (divide && depth > 0) {
+        counter.nodes++;
+        for (const auto &move : generate(root)) {
+            const uint64_t count = perft(play(root, move), depth - 1, generate, play, counter);
+            std::printf("%-12s %llu\n", name(move).c_str(), (unsigned long long)count);
+            leaves += count;
+        }
+        std::printf("\n");
+    } else {
+        leaves = perft(root, depth, generate, play, counter);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("depth %d  leaves %llu  nodes %llu  time %.3f s  %.0f nodes/s\n",
+                depth, (unsigned long long)leaves, (unsigned long long)counter.nodes, seconds,
+                seconds > 0.0 ? counter.nodes / seconds : 0.0);
+}
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s <othello[:reference]|checkers|connect4[:WxH]> <depth> [state|-] [--player=N] [--divide] [--kernel=K]\n", program);
+    return 1;
+}
+
+template <class Board>
+int runOthello(const std::string &state, int player, int depth, bool divide)
+{
+    OthelloPosition<Board> root = {Board(), player};
+    if (!state.empty() && !root.board.setStateString(state)) {
+        std::fprintf(stderr, "bad Othello state string\n");
+        return 1;
+    }
+    run(root, depth, divide, othelloMoves<Board>, othelloPlay<Board>, othelloMoveName);
+    return 0;
+}
+
+template <int W, int H>
+int runConnect4(const std::string &state, int depth, bool divide)
+{
+    // the side to move follows from the stone count
+    typedef BasicConnect4Board<W, H> Board;
+    Board root;
+    if (!state.empty() && !root.setStateString(state)) {
+        std::fprintf(stderr, "bad Connect4 state string\n");
+        return 1;
+    }
+    run(root, depth, divide, connect4Moves<Board>, connect4Play<Board>, connect4MoveName);
+    return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) return usage(argv[0]);
+
+    const std::string game = argv[1];
+    const int depth = std::atoi(argv[2]);
+    std::string state;
+    int player = 0;
+    bool divide = false;
+
+    for (int i = 3; i < argc; i++) {
+        if (std::strncmp(argv[i], "--player=", 9) == 0) {
+            player = std::atoi(argv[i] + 9);
+        } else if (std::strcmp(argv[i], "--divide") == 0) {
+            divide = true;
+        } else if (std::strncmp(argv[i], "--kernel=", 9) == 0) {
+            int kernel = 0;
+            while (kernel < OthelloBoard::KERNEL_COUNT && std::strcmp(argv[i] + 9, OthelloBoard::kernelName((OthelloBoard::Kernel)kernel)) != 0)
+                kernel++;
+            if (kernel == OthelloBoard::KERNEL_COUNT) return usage(argv[0]);
+            if (!OthelloBoard::setKernel((OthelloBoard::Kernel)kernel)) {
+                std::fprintf(stderr, "kernel %s is not available on this CPU\n", argv[i] + 9);
+                return 1;
+            }
+        } else if (argv[i][0] != '-' || argv[i][1] != '\0') {
+            state = argv[i];
+        }
+    }
+    if (depth < 0 || (player != 0 && player != 1)) return usage(argv[0]);
+
+    if (game == "othello") {
+        std::printf("kernel %s\n", OthelloBoard::kernelName(OthelloBoard::kernel()));
+        return runOthello<OthelloBoard>(state, player, depth, divide);
+    } else if (game == "othello:reference") {
+        return runOthello<OthelloReferenceBoard>(state, player, depth, divide);
+    } else if (game == "checkers") {
+        CheckersPosition root = {CheckersBoard(), player};
+        if (!state.empty() && !root.board.setStateString(state)) {
+            std::fprintf(stderr, "bad Checkers state string\n");
+            return 1;
+        }
+        run(root, depth, divide, checkersMoves, checkersPlay, checkersMoveName);
+    } else if (game == "connect4" || game == "connect4:7x6") {
+        return runConnect4<7, 6>(state, depth, divide);
+    } else if (game == "connect4:8x7") {
+        return runConnect4<8, 7>(state, depth, divide);
+    } else if (game == "connect4:6x5") {
+        return runConnect4<6, 5>(state, depth, divide);
+#ifdef CONNECT4_WIDE_BOARDS
+    } else if (game == "connect4:9x7") {
+        return runConnect4<9, 7>(state, depth, divide);
+#endif
+    } else {
+        return usage(argv[0]);
+    }
+    return 0;
+}
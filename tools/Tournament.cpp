@@ -0,0 +1,478 @@
+#include "Connect4Search.h"
+#include "OthelloBoard.h"
+#include "OthelloPatterns.h"
+#include "OthelloSearch.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// tournament: engine-vs-engine matches on every core, for validating search changes
+//
+//   tournament <connect4|othello> [--a=SPEC] [--b=SPEC] [--games=N] [--openings=P]
+//              [--threads=T] [--seed=S] [--sprt=ELO0,ELO1] [--alpha=A] [--beta=B]
+//
+// engine A plays engine B. every game starts from P random plies (one random
+// opening per pair of games) and each opening is played twice with the colours
+// swapped, so neither engine profits from a lucky opening or from moving first.
+// games run as tasks on a thread pool; each worker keeps its own pair of engines.
+//
+// a SPEC is a comma-separated list of key=value settings:
+//   connect4: depth=8 time=0 table=4 (MB) pvs=1 aspiration=8 center=1 ttmove=1
+//             killers=0 history=0, the Connect4Search options of the same names
+//   othello:  type=search (the game's AI) with depth=6 time=0 table=4 (MB),
+//             solve=0 (empty squares from which the exact solver plays) and
+//             weights= (a pattern weights file from otrain; none evaluates by hand),
+//             type=greedy (most flips, the game's old AI) or type=random
+// Checkers is left out until it has an AI.
+//
+// the result is reported from engine A's side as wins, losses and draws, the
+// score, the Elo difference with a 95% interval and the likelihood of
+// superiority. with --sprt the match also runs a sequential probability ratio
+// test of H0: elo = ELO0 against H1: elo = ELO1 and stops as soon as it decides,
+// using the normal approximation of the game results that fishtest used.
+//
+namespace {
+
+typedef std::map<std::string, std::string> Spec;
+
+bool parseSpec(const std::string &text, Spec &spec)
+{
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const size_t equals = item.find('=');
+        if (item.empty()) continue;
+        if (equals == std::string::npos || equals == 0)
+            return false;
+        spec[item.substr(0, equals)] = item.substr(equals + 1);
+    }
+    return true;
+}
+
+// consumes the setting so leftover keys can be reported as unknown
+int takeInt(Spec &spec, const char *key, int value)
+{
+    auto it = spec.find(key);
+    if (it == spec.end())
+        return value;
+    value = std::atoi(it->second.c_str());
+    spec.erase(it);
+    return value;
+}
+
+std::string takeString(Spec &spec, const char *key, const std::string &value)
+{
+    auto it = spec.find(key);
+    if (it == spec.end())
+        return value;
+    const std::string result = it->second;
+    spec.erase(it);
+    return result;
+}
+
+//
+// Connect4: a Connect4Search per engine
+//
+class Connect4Player
+{
+public:
+    explicit Connect4Player(Spec spec)
+    {
+        _limits.maxDepth = takeInt(spec, "depth", 8);
+        _limits.timeBudgetMs = takeInt(spec, "time", 0);
+        _limits.threads = 1;
+
+        Connect4SearchWindows windows;
+        windows.pvs = takeInt(spec, "pvs", windows.pvs) != 0;
+        windows.aspirationDelta = takeInt(spec, "aspiration", windows.aspirationDelta);
+        Connect4MoveOrdering ordering;
+        ordering.centerFirst = takeInt(spec, "center", ordering.centerFirst) != 0;
+        ordering.tableMove = takeInt(spec, "ttmove", ordering.tableMove) != 0;
+        ordering.killers = takeInt(spec, "killers", ordering.killers) != 0;
+        ordering.history = takeInt(spec, "history", ordering.history) != 0;
+
+        _search = std::make_unique<Connect4Search>((size_t)takeInt(spec, "table", 4));
+        _search->setWindows(windows);
+        _search->setMoveOrdering(ordering);
+        _unknown = spec.empty() ? "" : spec.begin()->first;
+        _valid = _unknown.empty() && (_limits.maxDepth > 0 || _limits.timeBudgetMs > 0);
+    }
+
+    bool        valid() const { return _valid; }
+    const std::string &unknownKey() const { return _unknown; }
+    void        newGame(uint32_t seed) { _search->newGame(); }
+    int         move(const Connect4Board &board) { return _search->search(board, _limits).move; }
+
+private:
+    std::unique_ptr<Connect4Search> _search;
+    Connect4SearchLimits _limits;
+    std::string _unknown;
+    bool        _valid;
+};
+
+struct Connect4Match
+{
+    typedef Connect4Player Player;
+    typedef Connect4Board Position;
+
+    // P random plies that do not end the game
+    static Position opening(std::mt19937 &rng, int plies)
+    {
+        for (;;) {
+            Connect4Board board;
+            int ply = 0;
+            for (; ply < plies; ply++) {
+                const int column = (int)(rng() % Connect4Board::WIDTH);
+                if (!board.canPlay(column) || board.isWinningMove(column)) break;
+                board.play(column);
+            }
+            if (ply == plies) return board;
+        }
+    }
+
+    // +1 when the side to move at the start wins, -1 when it loses, 0 for a draw
+    static int play(Position board, Player *players[2])
+    {
+        const int first = board.currentPlayer();
+        for (;;) {
+            if (board.isFull())
+                return 0;
+            Player &player = *players[board.currentPlayer() == first ? 0 : 1];
+            const int column = player.move(board);
+            if (column < 0 || !board.canPlay(column))
+                return board.currentPlayer() == first ? -1 : 1;
+            board.play(column);
+            if (board.lastMoveOutcome().winner >= 0)
+                return board.lastMoveOutcome().winner == first ? 1 : -1;
+        }
+    }
+};
+
+//
+// Othello: the game's search, the old greedy AI or uniformly random moves
+//
+class OthelloPlayer
+{
+public:
+    explicit OthelloPlayer(Spec spec)
+    {
+        const std::string type = takeString(spec, "type", "search");
+        _random = type == "random";
+        if (type == "search") {
+            _limits.maxDepth = takeInt(spec, "depth", 6);
+            _limits.timeBudgetMs = takeInt(spec, "time", 0);
+            _limits.solveEmpties = takeInt(spec, "solve", 0);
+            _search = std::make_unique<OthelloSearch>((size_t)takeInt(spec, "table", 4));
+            const std::string weights = takeString(spec, "weights", "");
+            if (!weights.empty() && _patterns.open(weights))
+                _search->setPatterns(&_patterns);
+            _weightsMissing = !weights.empty() && !_patterns.isOpen();
+        }
+        _unknown = spec.empty() ? "" : spec.begin()->first;
+        _valid = _unknown.empty() && !_weightsMissing && (type == "search" || type == "greedy" || type == "random") &&
+                 (!_search || _limits.maxDepth > 0 || _limits.timeBudgetMs > 0);
+    }
+
+    bool        valid() const { return _valid; }
+    const std::string &unknownKey() const { return _unknown; }
+    void        newGame(uint32_t seed)
+    {
+        _rng.seed(seed);
+        if (_search)
+            _search->newGame();
+    }
+    // false when the player has to pass
+    bool        move(const OthelloBoard &board, int player, std::pair<int, int> &move)
+    {
+        if (_search) {
+            const int square = _search->search(board, player, _limits).move;
+            if (square < 0)
+                return false;
+            move = {square % OthelloBoard::SIZE, square / OthelloBoard::SIZE};
+            return true;
+        }
+        const auto moves = board.getValidMoves(player);
+        if (moves.empty())
+            return false;
+        if (_random) {
+            move = moves[_rng() % moves.size()];
+            return true;
+        }
+        int bestFlips = -1;
+        for (const std::pair<int, int> &candidate : moves) {
+            const int flips = board.countFlips(candidate.first, candidate.second, player);
+            if (flips > bestFlips) {
+                bestFlips = flips;
+                move = candidate;
+            }
+        }
+        return true;
+    }
+
+private:
+    OthelloPatterns _patterns;
+    std::unique_ptr<OthelloSearch> _search;    // null for greedy and random
+    OthelloSearchLimits _limits;
+    std::mt19937 _rng;
+    bool        _random;
+    bool        _weightsMissing = false;
+    std::string _unknown;
+    bool        _valid;
+};
+
+struct OthelloMatch
+{
+    typedef OthelloPlayer Player;
+    struct Position {
+        OthelloBoard board;
+        int player;
+    };
+
+    static Position opening(std::mt19937 &rng, int plies)
+    {
+        for (;;) {
+            Position position = {OthelloBoard(), OthelloBoard::BLACK_PLAYER};
+            int ply = 0;
+            for (; ply < plies && !position.board.isGameOver(); ply++) {
+                const auto moves = position.board.getValidMoves(position.player);
+                if (!moves.empty()) {
+                    const std::pair<int, int> &move = moves[rng() % moves.size()];
+                    position.board.play(move.first, move.second, position.player);
+                }
+                position.player = 1 - position.player;
+            }
+            if (ply == plies) return position;
+        }
+    }
+
+    static int play(Position position, Player *players[2])
+    {
+        const int first = position.player;
+        while (!position.board.isGameOver()) {
+            Player &player = *players[position.player == first ? 0 : 1];
+            std::pair<int, int> move;
+            if (player.move(position.board, position.player, move))
+                position.board.play(move.first, move.second, position.player);
+            position.player = 1 - position.player;
+        }
+        int discs[2];
+        position.board.countPieces(discs[OthelloBoard::BLACK_PLAYER], discs[OthelloBoard::WHITE_PLAYER]);
+        const int margin = discs[first] - discs[1 - first];
+        return margin > 0 ? 1 : (margin < 0 ? -1 : 0);
+    }
+};
+
+struct Options
+{
+    std::string specs[2];
+    int games = 1000;
+    int openingPlies = 4;
+    int threads = 0;
+    uint32_t seed = 1;
+    bool sprt = false;
+    double elo0 = 0.0, elo1 = 10.0;
+    double alpha = 0.05, beta = 0.05;
+};
+
+//
+// match statistics, from engine A's side
+//
+struct Tally
+{
+    int wins = 0, losses = 0, draws = 0;
+
+    int         games() const { return wins + losses + draws; }
+    double      score() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+    // variance of one game's result around the mean score
+    double      variance() const
+    {
+        const double s = score(), n = games();
+        return n ? (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / n : 0.0;
+    }
+};
+
+double eloFromScore(double score)
+{
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double scoreFromElo(double elo)
+{
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// log-likelihood ratio of H1 against H0, treating each game result as normally distributed
+double sprtLLR(const Tally &tally, double elo0, double elo1)
+{
+    const double variance = tally.variance();
+    if (tally.games() == 0 || variance <= 0.0)
+        return 0.0;
+    const double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+    return tally.games() * (s1 - s0) * (2.0 * tally.score() - s0 - s1) / (2.0 * variance);
+}
+
+void printTally(const Tally &tally, const Options &options, double seconds)
+{
+    const double margin = tally.games() ? 1.96 * std::sqrt(tally.variance() / tally.games()) : 0.0;
+    const double elo = eloFromScore(tally.score());
+    const int decisive = tally.wins + tally.losses;
+    const double los = decisive ? 0.5 * (1.0 + std::erf((tally.wins - tally.losses) / std::sqrt(2.0 * decisive))) : 0.5;
+    std::printf("games %d  +%d -%d =%d  score %.3f  elo %+.1f [%+.1f, %+.1f]  los %.1f%%",
+                tally.games(), tally.wins, tally.losses, tally.draws, tally.score(), elo,
+                eloFromScore(tally.score() - margin), eloFromScore(tally.score() + margin), 100.0 * los);
+    if (options.sprt) {
+        std::printf("  llr %.2f [%.2f, %.2f]", sprtLLR(tally, options.elo0, options.elo1),
+                    std::log(options.beta / (1.0 - options.alpha)), std::log((1.0 - options.beta) / options.alpha));
+    }
+    std::printf("  %.1f games/s\n", seconds > 0.0 ? tally.games() / seconds : 0.0);
+}
+
+template <class Match>
+int runMatch(const Options &options)
+{
+    typedef typename Match::Player Player;
+    for (int i = 0; i < 2; i++) {
+        Spec spec;
+        const bool parsed = parseSpec(options.specs[i], spec);
+        const Player player(spec);
+        if (!parsed || !player.valid()) {
+            std::fprintf(stderr, "bad engine %c settings: %s", 'A' + i, options.specs[i].c_str());
+            if (!player.unknownKey().empty())
+                std::fprintf(stderr, " (unknown key %s)", player.unknownKey().c_str());
+            std::fprintf(stderr, "\n");
+            return 1;
+        }
+    }
+
+    ThreadPool pool(options.threads);
+    // engine A and engine B of every worker
+    std::vector<std::unique_ptr<Player>> players(2 * pool.threadCount());
+
+    std::mutex lock;
+    Tally tally;
+    std::atomic<bool> decided(false);
+    const double lower = std::log(options.beta / (1.0 - options.alpha));
+    const double upper = std::log((1.0 - options.beta) / options.alpha);
+    const int reportEvery = std::max(options.games / 20, 10);
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    for (int game = 0; game < options.games; game++) {
+        pool.submit([&, game] {
+            if (decided) return;
+            const int worker = ThreadPool::workerIndex();
+            for (int i = 0; i < 2; i++) {
+                if (!players[2 * worker + i]) {
+                    Spec spec;
+                    parseSpec(options.specs[i], spec);
+                    players[2 * worker + i] = std::make_unique<Player>(spec);
+                }
+                players[2 * worker + i]->newGame(options.seed * 7919u + (uint32_t)game * 2u + (uint32_t)i);
+            }
+
+            // both games of a pair share the opening; in the odd one engine B moves first
+            std::mt19937 rng(options.seed + (uint32_t)(game / 2) * 104729u);
+            const auto position = Match::opening(rng, options.openingPlies);
+            const bool swapped = game % 2 == 1;
+            Player *order[2] = {players[2 * worker + (swapped ? 1 : 0)].get(), players[2 * worker + (swapped ? 0 : 1)].get()};
+            const int result = Match::play(position, order) * (swapped ? -1 : 1);
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (decided) return;
+            if (result > 0) tally.wins++;
+            else if (result < 0) tally.losses++;
+            else tally.draws++;
+
+            if (options.sprt) {
+                const double llr = sprtLLR(tally, options.elo0, options.elo1);
+                if (llr <= lower || llr >= upper) {
+                    decided = true;
+                    printTally(tally, options, elapsed());
+                    std::printf("SPRT accepts H%d (elo %+g) after %d games\n", llr >= upper ? 1 : 0,
+                                llr >= upper ? options.elo1 : options.elo0, tally.games());
+                    return;
+                }
+            }
+            if (tally.games() % reportEvery == 0 && tally.games() < options.games) {
+                printTally(tally, options, elapsed());
+                std::fflush(stdout);
+            }
+        });
+    }
+    pool.wait();
+
+    if (!decided) {
+        printTally(tally, options, elapsed());
+        if (options.sprt)
+            std::printf("SPRT undecided after %d games\n", tally.games());
+    }
+    return 0;
+}
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s <connect4|othello> [--a=SPEC] [--b=SPEC] [--games=N] [--openings=P] [--threads=T] "
+                         "[--seed=S] [--sprt=ELO0,ELO1] [--alpha=A] [--beta=B]\n", program);
+    return 1;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) return usage(argv[0]);
+
+    const std::string game = argv[1];
+    Options options;
+    for (int i = 2; i < argc; i++) {
+        if (std::strncmp(argv[i], "--a=", 4) == 0) {
+            options.specs[0] = argv[i] + 4;
+        } else if (std::strncmp(argv[i], "--b=", 4) == 0) {
+            options.specs[1] = argv[i] + 4;
+        } else if (std::strncmp(argv[i], "--games=", 8) == 0) {
+            options.games = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--openings=", 11) == 0) {
+            options.openingPlies = std::atoi(argv[i] + 11);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            options.threads = std::atoi(argv[i] + 10);
+        } else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            options.seed = (uint32_t)std::strtoul(argv[i] + 7, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--sprt=", 7) == 0) {
+            options.sprt = std::sscanf(argv[i] + 7, "%lf,%lf", &options.elo0, &options.elo1) == 2;
+            if (!options.sprt) return usage(argv[0]);
+        } else if (std::strncmp(argv[i], "--alpha=", 8) == 0) {
+            options.alpha = std::atof(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--beta=", 7) == 0) {
+            options.beta = std::atof(argv[i] + 7);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.games < 1 || options.openingPlies < 0 || options.alpha <= 0.0 || options.alpha >= 0.5 ||
+        options.beta <= 0.0 || options.beta >= 0.5 || (options.sprt && options.elo1 <= options.elo0))
+        return usage(argv[0]);
+
+    if (game == "connect4")
+        return runMatch<Connect4Match>(options);
+    if (game == "othello")
+        return runMatch<OthelloMatch>(options);
+    if (game == "checkers") {
+        std::fprintf(stderr, "Checkers has no AI yet\n");
+        return 1;
+    }
+    return usage(argv[0]);
+}